@@ -0,0 +1,39 @@
+#pragma once
+
+#include <exa/concepts.hpp>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    // Recycles equally sized buffers so hot paths don't allocate per operation.
+    class buffer_pool
+    {
+    public:
+        using buffer = std::vector<uint8_t>;
+
+        explicit buffer_pool(size_t buffer_size, size_t max_free = 1024);
+        buffer_pool(const buffer_pool&) = delete;
+        virtual ~buffer_pool() = default;
+
+        size_t buffer_size() const;
+        size_t max_free() const;
+        size_t available() const;
+
+        buffer acquire();
+        // Buffers beyond max_free or with less capacity than buffer_size are freed instead.
+        void release(buffer&& b);
+
+    private:
+        struct buffers : public std::vector<buffer>, public lockable<std::mutex>
+        {
+        };
+
+        size_t buffer_size_;
+        size_t max_free_;
+        buffers free_;
+    };
+}
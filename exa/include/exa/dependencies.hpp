@@ -12,6 +12,7 @@
 
 #include <WinSock2.h>
 #include <WS2tcpip.h>
+#include <afunix.h>
 #include <Windows.h>
 
 namespace exa
@@ -65,12 +66,15 @@ namespace exa
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <sys/ioctl.h>
 #include <sys/file.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <poll.h>
 #include <fcntl.h>
 #include <unistd.h>
 
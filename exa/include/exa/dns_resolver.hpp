@@ -0,0 +1,53 @@
+#pragma once
+
+#include <exa/address.hpp>
+#include <exa/endpoint.hpp>
+#include <exa/socket_base.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    struct dns_resolver_options
+    {
+        // Name servers to query. If empty, the name servers from resolv_conf_path are used.
+        std::vector<endpoint> name_servers;
+        std::string hosts_path = "/etc/hosts";
+        std::string resolv_conf_path = "/etc/resolv.conf";
+        bool use_hosts = true;
+        address_family family = address_family::unspecified;
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(2000);
+        size_t attempts = 2;
+        std::chrono::seconds max_ttl = std::chrono::seconds(3600);
+        std::chrono::seconds negative_ttl = std::chrono::seconds(30);
+        size_t cache_size = 1024;
+    };
+
+    class dns_resolver
+    {
+    public:
+        dns_resolver();
+        dns_resolver(const dns_resolver&) = delete;
+        explicit dns_resolver(const dns_resolver_options& options);
+        virtual ~dns_resolver() = default;
+
+        const std::vector<endpoint>& name_servers() const;
+        size_t cache_entries() const;
+        void clear_cache();
+
+        std::vector<address> lookup(const std::string& host);
+        std::shared_future<std::vector<address>> lookup_async(const std::string& host);
+        std::vector<endpoint> resolve(const std::string& host, uint16_t port);
+        std::future<std::vector<endpoint>> resolve_async(const std::string& host, uint16_t port);
+
+    private:
+        struct resolver_state;
+        std::shared_ptr<resolver_state> state_;
+    };
+}
@@ -17,16 +17,24 @@ namespace exa
         endpoint(uint32_t address, uint16_t port);
         endpoint(const address& address, uint16_t port);
         explicit endpoint(const sockaddr_storage& storage);
+        endpoint(const sockaddr_storage& storage, size_t length);
 
         address_family family() const;
         const address& address() const;
         uint16_t port() const;
+        const std::string& path() const;
+        bool abstract() const;
         std::vector<uint8_t> serialize() const;
 
+        static endpoint unix_path(const std::string& path);
+        static endpoint unix_abstract(const std::string& name);
         static std::vector<endpoint> get_address_info(const std::string& host, const std::string& service);
 
     private:
         exa::address address_;
         uint16_t port_ = 0;
+        std::string path_;
+        bool unix_ = false;
+        bool abstract_ = false;
     };
 }
@@ -48,6 +48,12 @@ namespace exa
     class file_stream : public stream
     {
     public:
+#ifdef _WIN32
+        using native_handle_type = HANDLE;
+#else
+        typedef int native_handle_type;
+#endif
+
         file_stream() = default;
         file_stream(const file_stream&) = delete;
         file_stream(const std::string& path, file_mode mode, file_access access = file_access::read_write,
@@ -82,6 +88,8 @@ namespace exa
         // Specific to file_stream
         const std::string& name() const;
 
+        native_handle_type native_handle() const;
+
     private:
         struct file_stream_context;
         std::unique_ptr<file_stream_context> context_;
@@ -70,6 +70,14 @@ namespace exa
         virtual std::future<void> write_async(gsl::span<const uint8_t> buffer) override;
 
         // Specific to network_stream
+        std::streamsize read(gsl::span<const gsl::span<uint8_t>> buffers);
+
+        std::future<std::streamsize> read_async(gsl::span<const gsl::span<uint8_t>> buffers);
+
+        void write(gsl::span<const gsl::span<const uint8_t>> buffers);
+
+        std::future<void> write_async(gsl::span<const gsl::span<const uint8_t>> buffers);
+
         bool data_available() const;
 
         const std::shared_ptr<socket>& socket() const;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace exa
+{
+    namespace detail
+    {
+        // Calls a function every interval on its own thread until stopped.
+        class periodic_worker
+        {
+        public:
+            periodic_worker() = default;
+            periodic_worker(const periodic_worker&) = delete;
+            ~periodic_worker();
+
+            bool running() const;
+
+            // Does nothing if the worker is already running.
+            void start(const std::chrono::milliseconds& interval, std::function<void()> work);
+            void stop();
+
+        private:
+            std::atomic_bool run_{false};
+            // Serializes start and stop, so only one of them touches the thread at a time.
+            std::mutex control_mutex_;
+            std::mutex wait_mutex_;
+            std::condition_variable wait_signal_;
+            std::thread thread_;
+        };
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <exa/socket.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    enum class poll_events : uint32_t
+    {
+        none = 0,
+        read = 1,
+        write = 2,
+        error = 4,
+        hang_up = 8,
+        edge_triggered = 16,
+        one_shot = 32
+    };
+
+    struct poll_event
+    {
+        std::shared_ptr<socket> socket;
+        poll_events events = poll_events::none;
+        void* user_data = nullptr;
+    };
+
+    class poller
+    {
+    public:
+        poller();
+        poller(const poller&) = delete;
+        virtual ~poller();
+
+        size_t size() const;
+        bool contains(const std::shared_ptr<socket>& s) const;
+
+        void add(const std::shared_ptr<socket>& s, poll_events events, void* user_data = nullptr);
+        void modify(const std::shared_ptr<socket>& s, poll_events events);
+        void modify(const std::shared_ptr<socket>& s, poll_events events, void* user_data);
+        void remove(const std::shared_ptr<socket>& s);
+        void notify();
+
+        // Waits for at most events.size() ready sockets. A negative timeout waits indefinitely.
+        size_t wait(gsl::span<poll_event> events, const std::chrono::milliseconds& timeout);
+
+    private:
+        struct poller_context;
+        std::unique_ptr<poller_context> context_;
+    };
+}
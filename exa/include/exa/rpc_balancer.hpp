@@ -0,0 +1,78 @@
+#pragma once
+
+#include <exa/rpc_client.hpp>
+#include <exa/endpoint.hpp>
+#include <exa/concepts.hpp>
+#include <exa/periodic_worker.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    enum class rpc_balance_policy
+    {
+        least_outstanding,
+        lowest_latency
+    };
+
+    struct rpc_balancer_options
+    {
+        rpc_balance_policy policy = rpc_balance_policy::least_outstanding;
+        rpc_options rpc;
+        // Weight of a new sample in the latency average.
+        double latency_weight = 0.2;
+        // Backends whose average latency exceeds this are ejected, zero disables it.
+        std::chrono::microseconds max_latency{0};
+        // Ejected backends are reconnected in the background once this time passed, calls never wait for it.
+        std::chrono::milliseconds ejection_time = std::chrono::seconds(5);
+    };
+
+    struct rpc_backend_status
+    {
+        endpoint ep;
+        size_t outstanding = 0;
+        std::chrono::microseconds latency{0};
+        uint64_t completed = 0;
+        uint64_t ejections = 0;
+        bool ejected = false;
+    };
+
+    // Keeps a connection to every backend and sends each call to the best one according to the policy. Backends
+    // that lose their connection or get too slow are ejected for a while.
+    class rpc_balancer
+    {
+    public:
+        rpc_balancer() = delete;
+        rpc_balancer(const rpc_balancer&) = delete;
+        explicit rpc_balancer(const std::vector<endpoint>& endpoints,
+                              const rpc_balancer_options& options = rpc_balancer_options());
+        virtual ~rpc_balancer();
+
+        const rpc_balancer_options& options() const;
+        size_t size() const;
+        size_t available() const;
+        std::vector<rpc_backend_status> status() const;
+
+        // Fails with std::runtime_error if no backend is available.
+        std::future<std::vector<uint8_t>> call(gsl::span<const uint8_t> request);
+
+    private:
+        struct backend;
+
+        std::shared_ptr<backend> select();
+        void revive_expired();
+        void revive(backend& b);
+        static void eject(backend& b, const rpc_balancer_options& options);
+
+        rpc_balancer_options options_;
+        std::vector<std::shared_ptr<backend>> backends_;
+        std::atomic_size_t next_{0};
+        detail::periodic_worker worker_;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <exa/rpc_codec.hpp>
+#include <exa/tcp_client.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    // Gets the response or the error, on the client's reader thread or the thread closing the client. Mustn't throw.
+    using rpc_callback = std::function<void(std::vector<uint8_t>&& response, std::exception_ptr error)>;
+
+    // Pipelines requests over one connection and matches responses by correlation ID, in any order.
+    class rpc_client
+    {
+    public:
+        rpc_client() = delete;
+        rpc_client(const rpc_client&) = delete;
+        explicit rpc_client(const std::shared_ptr<tcp_client>& client, const rpc_options& options = rpc_options());
+        virtual ~rpc_client();
+
+        bool closed() const;
+        size_t outstanding() const;
+        const std::shared_ptr<tcp_client>& client() const;
+
+        // Blocks while max_outstanding requests are in flight. Requests queued while the previous batch is being
+        // written go out together in a single write. Fails with std::runtime_error if the server's handler threw
+        // or the connection was lost.
+        std::future<std::vector<uint8_t>> call(gsl::span<const uint8_t> request);
+        void call(gsl::span<const uint8_t> request, const rpc_callback& callback);
+        // Fails all outstanding requests and shuts the connection down.
+        void close();
+
+    private:
+        void read_loop();
+        void write_loop();
+        void fail(const std::string& message);
+
+        std::shared_ptr<tcp_client> client_;
+        rpc_options options_;
+        rpc_codec codec_;
+        std::shared_ptr<network_stream> stream_;
+        mutable std::mutex mutex_;
+        std::condition_variable slots_;
+        std::condition_variable queued_signal_;
+        std::unordered_map<uint64_t, rpc_callback> pending_;
+        std::vector<uint8_t> queued_;
+        uint64_t next_id_ = 0;
+        bool closed_ = false;
+        std::thread reader_;
+        std::thread writer_;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <exa/socket.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    enum class rpc_frame_kind : uint8_t
+    {
+        request = 0,
+        response = 1,
+        // The payload is the message of the exception thrown by the handler.
+        error = 2
+    };
+
+    struct rpc_frame
+    {
+        rpc_frame_kind kind = rpc_frame_kind::request;
+        uint64_t id = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    struct rpc_options
+    {
+        size_t max_outstanding = 128;
+        size_t max_frame_size = 16 * 1024 * 1024;
+    };
+
+    // Frames start with the payload length (4 bytes), the correlation ID (8 bytes) and the kind (1 byte), all big
+    // endian, followed by the payload.
+    class rpc_codec
+    {
+    public:
+        static constexpr size_t header_size = 13;
+
+        explicit rpc_codec(size_t max_frame_size = rpc_options().max_frame_size);
+
+        static void encode(std::vector<uint8_t>& out, rpc_frame_kind kind, uint64_t id,
+                           gsl::span<const uint8_t> payload);
+        // Returns the frames completed by data, a trailing partial frame is kept for the next call.
+        std::vector<rpc_frame> decode(gsl::span<const uint8_t> data);
+
+        size_t buffered() const;
+
+    private:
+        size_t max_frame_size_;
+        std::vector<uint8_t> pending_;
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <exa/rpc_codec.hpp>
+#include <exa/tcp_server.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    class rpc_responder
+    {
+    public:
+        // Either may be called once, from any thread. Responses given while the handler runs are batched with
+        // the other responses to the same read.
+        void reply(gsl::span<const uint8_t> response) const;
+        void fail(const std::string& message) const;
+
+    private:
+        struct batch;
+
+        rpc_responder(const std::shared_ptr<tcp_connection>& c, const std::shared_ptr<batch>& b, uint64_t id);
+        void send(rpc_frame_kind kind, gsl::span<const uint8_t> payload) const;
+
+        std::weak_ptr<tcp_connection> connection_;
+        std::shared_ptr<batch> batch_;
+        uint64_t id_;
+
+        friend class rpc_server;
+    };
+
+    // Runs on the connection's I/O loop, slow requests should keep the responder and reply from elsewhere.
+    // Exceptions thrown by the handler are sent back as errors.
+    using rpc_handler = std::function<void(gsl::span<const uint8_t> request, const rpc_responder& respond)>;
+
+    class rpc_server
+    {
+    public:
+        rpc_server() = delete;
+        rpc_server(const rpc_server&) = delete;
+        rpc_server(const endpoint& ep, const rpc_handler& handler, const rpc_options& options = rpc_options(),
+                   const tcp_server_options& server_options = tcp_server_options());
+        virtual ~rpc_server();
+
+        bool active() const;
+        size_t connections() const;
+        endpoint local_endpoint() const;
+
+        void start();
+        void stop();
+
+    private:
+        void on_received(const std::shared_ptr<tcp_connection>& c, gsl::span<const uint8_t> data);
+
+        rpc_handler handler_;
+        rpc_options options_;
+        std::unique_ptr<tcp_server> server_;
+    };
+}
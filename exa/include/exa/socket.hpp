@@ -9,6 +9,9 @@
 #include <vector>
 #include <string>
 #include <future>
+#include <memory>
+#include <optional>
+#include <system_error>
 
 namespace exa
 {
@@ -18,12 +21,92 @@ namespace exa
         std::chrono::seconds linger_time;
     };
 
+    struct port_range
+    {
+        uint16_t low = 0;
+        uint16_t high = 0;
+
+        // Splits the range into count parts of equal size and returns the part at index, e.g. one per worker.
+        port_range shard(size_t index, size_t count) const;
+    };
+
+    // Options which are left empty keep the system default when applied.
+    struct socket_tuning
+    {
+        // Need to be applied before binding or connecting.
+        std::optional<bool> bind_address_no_port;
+        std::optional<port_range> local_port_range;
+        std::optional<bool> no_delay;
+        std::optional<bool> quick_ack;
+        std::optional<bool> cork;
+        std::optional<size_t> send_buffer;
+        std::optional<size_t> receive_buffer;
+        std::optional<size_t> not_sent_low_water;
+        std::optional<size_t> receive_low_water;
+        std::optional<std::chrono::microseconds> busy_poll;
+        std::optional<int> incoming_cpu;
+        std::optional<linger_option> linger_state;
+    };
+
     struct socket_receive_from_result
     {
         size_t bytes = 0;
         endpoint endpoint;
     };
 
+    struct socket_timestamp
+    {
+        // Time since the epoch, empty if it wasn't reported. Packets arriving right after timestamping got enabled
+        // may not be stamped yet. Hardware time comes from the network card clock.
+        std::optional<std::chrono::nanoseconds> software;
+        std::optional<std::chrono::nanoseconds> hardware;
+    };
+
+    struct socket_tcp_info
+    {
+        uint8_t state = 0;
+        std::chrono::microseconds rtt{0};
+        std::chrono::microseconds rtt_variance{0};
+        std::chrono::microseconds min_rtt{0};
+        uint32_t retransmits = 0;
+        uint32_t lost = 0;
+        // Congestion window and slow start threshold are counted in segments of send_mss bytes.
+        uint32_t congestion_window = 0;
+        uint32_t slow_start_threshold = 0;
+        uint32_t send_mss = 0;
+        // Rates are in bytes per second.
+        uint64_t pacing_rate = 0;
+        uint64_t delivery_rate = 0;
+        // Estimated from the segments in flight.
+        size_t bytes_in_flight = 0;
+        size_t not_sent_bytes = 0;
+        uint64_t bytes_sent = 0;
+        uint64_t bytes_acked = 0;
+        uint64_t bytes_received = 0;
+        uint64_t bytes_retransmitted = 0;
+    };
+
+    struct socket_receive_message
+    {
+        gsl::span<uint8_t> buffer;
+        endpoint endpoint;
+        size_t bytes = 0;
+    };
+
+    struct socket_send_message
+    {
+        gsl::span<const uint8_t> buffer;
+        // A default endpoint sends to the connected peer.
+        endpoint endpoint;
+    };
+
+    struct socket_receive_segments_result
+    {
+        size_t bytes = 0;
+        size_t segment_size = 0;
+        endpoint endpoint;
+    };
+
     class socket
     {
     public:
@@ -37,14 +120,20 @@ namespace exa
         socket(const socket&) = delete;
         socket(socket_type type, protocol_type protocol);
         socket(address_family family, socket_type type, protocol_type protocol);
+        socket(address_family family, socket_type type, protocol_type protocol, const socket_tuning& tuning);
         socket(native_handle_type s, address_family family, protocol_type protocol);
+        socket(native_handle_type s, address_family family, socket_type type, protocol_type protocol);
 
         ~socket();
 
+        // Takes ownership of a descriptor created elsewhere, e.g. received from another process.
+        static std::shared_ptr<socket> adopt(native_handle_type s, protocol_type protocol);
+
         bool valid() const;
         native_handle_type native_handle() const;
         bool connected() const;
         bool bound() const;
+        bool listening() const;
         address_family family() const;
         protocol_type protocol() const;
         socket_type type() const;
@@ -59,12 +148,46 @@ namespace exa
         void exclusive_address_use(bool value);
         bool reuse_address() const;
         void reuse_address(bool value);
+        bool reuse_port() const;
+        void reuse_port(bool value);
+        // Selects the socket of a reuse port group by the CPU that received the packet, modulo group_size.
+        void reuse_port_cpu_steering(size_t group_size);
+        // Defers picking the local port of a socket bound to port zero until connect, so the port can be shared
+        // with connections to other destinations.
+        bool bind_address_no_port() const;
+        void bind_address_no_port(bool value);
+        // Ephemeral ports picked for this socket, zero for both means the system wide range.
+        port_range local_port_range() const;
+        void local_port_range(const port_range& range);
         std::chrono::seconds ttl() const;
         void ttl(const std::chrono::seconds& value);
         linger_option linger_state() const;
         void linger_state(const linger_option& value);
         bool no_delay() const;
         void no_delay(bool value);
+        bool quick_ack() const;
+        void quick_ack(bool value);
+        bool cork() const;
+        void cork(bool value);
+        size_t not_sent_low_water() const;
+        void not_sent_low_water(size_t value);
+        size_t receive_low_water() const;
+        void receive_low_water(size_t value);
+        std::chrono::microseconds busy_poll() const;
+        void busy_poll(const std::chrono::microseconds& value);
+        int incoming_cpu() const;
+        void incoming_cpu(int value);
+        size_t fast_open() const;
+        void fast_open(size_t queue_length);
+        std::chrono::seconds defer_accept() const;
+        void defer_accept(const std::chrono::seconds& timeout);
+        bool receive_offload() const;
+        void receive_offload(bool value);
+        bool timestamping() const;
+        void timestamping(bool value);
+        bool zero_copy() const;
+        void zero_copy(bool value);
+        socket_tcp_info tcp_info() const;
         endpoint local_endpoint() const;
         endpoint remote_endpoint() const;
         size_t send_buffer() const;
@@ -76,14 +199,31 @@ namespace exa
         std::chrono::milliseconds receive_timeout() const;
         void receive_timeout(const std::chrono::milliseconds& value);
 
+        // Values set through this socket, reading them doesn't cost a system call. Options the kernel adjusts, like
+        // buffer sizes, hold the value read back after setting them, the others what was set.
+        const socket_tuning& tuning() const;
+        void apply(const socket_tuning& tuning);
+
         std::shared_ptr<socket> accept() const;
+        // The overloads taking an error_code report failed system calls through it instead of throwing.
+        std::shared_ptr<socket> accept(std::error_code& ec) const;
         std::future<std::shared_ptr<socket>> accept_async() const;
+        std::shared_ptr<socket> accept(const socket_tuning& tuning) const;
+        std::future<std::shared_ptr<socket>> accept_async(const socket_tuning& tuning) const;
+        // Accepts all pending connections up to max_count, only waits if none is pending yet.
+        std::vector<std::shared_ptr<socket>> accept_batch(size_t max_count, bool blocking = true) const;
+        std::future<std::vector<std::shared_ptr<socket>>> accept_batch_async(size_t max_count,
+                                                                             bool blocking = true) const;
         void bind(const address& addr, uint16_t port);
         void bind(const endpoint& local_ep);
         void close();
         void close(const std::chrono::seconds& wait_before_close);
         void connect(const endpoint& remote_ep);
+        void connect(const endpoint& remote_ep, std::error_code& ec);
         std::future<void> connect_async(const endpoint& remote_ep);
+        // Sends data with the SYN using TCP Fast Open if possible, otherwise after the handshake.
+        size_t connect(const endpoint& remote_ep, gsl::span<const uint8_t> data);
+        std::future<size_t> connect_async(const endpoint& remote_ep, gsl::span<const uint8_t> data);
         void connect(const address& addr, uint16_t port);
         std::future<void> connect_async(const address& addr, uint16_t port);
         void connect(const std::string& host, uint16_t port);
@@ -93,15 +233,59 @@ namespace exa
         void listen(size_t backlog) const;
         bool poll(const std::chrono::microseconds& us, select_mode mode) const;
         size_t receive(gsl::span<uint8_t> buffer, socket_flags flags = socket_flags::none) const;
+        size_t receive(gsl::span<uint8_t> buffer, std::error_code& ec, socket_flags flags = socket_flags::none) const;
         std::future<size_t> receive_async(gsl::span<uint8_t> buffer, socket_flags flags = socket_flags::none) const;
+        size_t receive(gsl::span<uint8_t> buffer, socket_timestamp& timestamp,
+                       socket_flags flags = socket_flags::none) const;
+        size_t receive(gsl::span<const gsl::span<uint8_t>> buffers, socket_flags flags = socket_flags::none) const;
+        std::future<size_t> receive_async(gsl::span<const gsl::span<uint8_t>> buffers,
+                                          socket_flags flags = socket_flags::none) const;
         size_t receive_from(gsl::span<uint8_t> buffer, endpoint& ep, socket_flags flags = socket_flags::none) const;
+        size_t receive_from(gsl::span<uint8_t> buffer, endpoint& ep, std::error_code& ec,
+                            socket_flags flags = socket_flags::none) const;
+        size_t receive_from(gsl::span<uint8_t> buffer, endpoint& ep, socket_timestamp& timestamp,
+                            socket_flags flags = socket_flags::none) const;
         std::future<socket_receive_from_result> receive_from_async(gsl::span<uint8_t> buffer,
                                                                    socket_flags flags = socket_flags::none) const;
         size_t send(gsl::span<const uint8_t> buffer, socket_flags flags = socket_flags::none) const;
+        size_t send(gsl::span<const uint8_t> buffer, std::error_code& ec, socket_flags flags = socket_flags::none) const;
+        // Waits until the kernel reported when the data left, timestamping must be enabled beforehand.
+        size_t send(gsl::span<const uint8_t> buffer, socket_timestamp& timestamp,
+                    socket_flags flags = socket_flags::none) const;
         std::future<size_t> send_async(gsl::span<const uint8_t> buffer, socket_flags flags = socket_flags::none) const;
+        size_t send(gsl::span<const gsl::span<const uint8_t>> buffers, socket_flags flags = socket_flags::none) const;
+        std::future<size_t> send_async(gsl::span<const gsl::span<const uint8_t>> buffers,
+                                       socket_flags flags = socket_flags::none) const;
+        // Completes once the kernel released the buffer, zero_copy must be enabled beforehand.
+        std::future<size_t> send_zero_copy_async(gsl::span<const uint8_t> buffer,
+                                                 socket_flags flags = socket_flags::none) const;
         size_t send_to(gsl::span<const uint8_t> buffer, const endpoint& ep, socket_flags flags = socket_flags::none) const;
+        size_t send_to(gsl::span<const uint8_t> buffer, const endpoint& ep, std::error_code& ec,
+                       socket_flags flags = socket_flags::none) const;
         std::future<size_t> send_to_async(gsl::span<const uint8_t> buffer, const endpoint& ep,
                                           socket_flags flags = socket_flags::none) const;
+        size_t send_segments(gsl::span<const uint8_t> buffer, size_t segment_size, const endpoint& ep = endpoint(),
+                             socket_flags flags = socket_flags::none) const;
+        std::future<size_t> send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size,
+                                                const endpoint& ep = endpoint(),
+                                                socket_flags flags = socket_flags::none) const;
+        socket_receive_segments_result receive_segments(gsl::span<uint8_t> buffer,
+                                                        socket_flags flags = socket_flags::none) const;
+        std::future<socket_receive_segments_result> receive_segments_async(gsl::span<uint8_t> buffer,
+                                                                           socket_flags flags = socket_flags::none) const;
+        size_t receive_batch(gsl::span<socket_receive_message> messages, socket_flags flags = socket_flags::none) const;
+        std::future<size_t> receive_batch_async(gsl::span<socket_receive_message> messages,
+                                                socket_flags flags = socket_flags::none) const;
+        size_t send_batch(gsl::span<const socket_send_message> messages, socket_flags flags = socket_flags::none) const;
+        std::future<size_t> send_batch_async(gsl::span<const socket_send_message> messages,
+                                             socket_flags flags = socket_flags::none) const;
+        // Passes descriptors over a unix domain socket along with at least one byte of data.
+        size_t send_descriptors(gsl::span<const native_handle_type> descriptors, gsl::span<const uint8_t> data,
+                                socket_flags flags = socket_flags::none) const;
+        // Received descriptors are owned by the caller and close on exec. Throws std::runtime_error if not all of
+        // them fit into the control buffer.
+        size_t receive_descriptors(gsl::span<uint8_t> buffer, std::vector<native_handle_type>& descriptors,
+                                   socket_flags flags = socket_flags::none) const;
         void shutdown(socket_shutdown flags) const;
 
         static void select(std::vector<std::shared_ptr<socket>>& read, std::vector<std::shared_ptr<socket>>& write,
@@ -151,6 +335,11 @@ namespace exa
         static void validate_native_handle(native_handle_type s);
         static void validate_transfer(int rc, const std::string& message);
         static void throw_error(const std::string& message);
+        static std::error_code last_error();
+        static size_t check_transfer(std::ptrdiff_t rc, std::error_code& ec);
+
+        struct error_queue_context;
+        void drain_error_queue() const;
 
         address_family family_;
         socket_type type_;
@@ -159,6 +348,8 @@ namespace exa
         bool is_connected_ = false;
         bool is_bound_ = false;
         bool is_blocking_ = true;
+        std::shared_ptr<error_queue_context> error_queue_;
+        socket_tuning tuning_;
 
         static bool ipv4_supported_;
         static bool ipv6_supported_;
@@ -74,6 +74,15 @@ namespace exa
         peek = MSG_PEEK,
         out_of_band = MSG_OOB,
         wait_all = MSG_WAITALL,
-        dont_route = MSG_DONTROUTE
+        dont_route = MSG_DONTROUTE,
+#ifdef _WIN32
+        no_signal = 0,
+        // Windows fails oversized datagrams with WSAEMSGSIZE instead.
+        truncate = 0
+#else
+        no_signal = MSG_NOSIGNAL,
+        // Datagram receives return the full length, even if only part of it fit into the buffer.
+        truncate = MSG_TRUNC
+#endif
     };
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <exa/socket.hpp>
+#include <exa/tcp_client.hpp>
+#include <exa/concepts.hpp>
+#include <exa/periodic_worker.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    struct socket_buffer_tuner_options
+    {
+        size_t min_buffer = 16 * 1024;
+        size_t max_buffer = 4 * 1024 * 1024;
+        // Upper bound for the sum of all send and receive buffers set by the tuner, buffers never go below min_buffer.
+        size_t memory_limit = 256 * 1024 * 1024;
+        // Factor applied to the bandwidth-delay product.
+        double headroom = 2.0;
+        // Buffers are only resized if the target differs by more than this fraction.
+        double hysteresis = 0.25;
+    };
+
+    // Sizes send and receive buffers of TCP connections from their measured bandwidth-delay product.
+    // Setting a buffer turns off the kernel's own autotuning for that connection.
+    class socket_buffer_tuner
+    {
+    public:
+        explicit socket_buffer_tuner(const socket_buffer_tuner_options& options = socket_buffer_tuner_options());
+        socket_buffer_tuner(const socket_buffer_tuner&) = delete;
+        virtual ~socket_buffer_tuner();
+
+        const socket_buffer_tuner_options& options() const;
+        size_t size() const;
+        size_t memory() const;
+        bool running() const;
+
+        // Sockets added before connecting start with the minimum buffers, connected ones keep their current buffers
+        // until the next tune. Sockets are held weakly.
+        void add(const std::shared_ptr<socket>& s);
+        void add(const std::shared_ptr<tcp_client>& c);
+        void remove(const std::shared_ptr<socket>& s);
+
+        // Measures every live connection and returns how many got resized.
+        size_t tune();
+
+        void start(const std::chrono::milliseconds& interval);
+        void stop();
+
+    private:
+        struct connection
+        {
+            std::weak_ptr<socket> socket;
+            std::chrono::steady_clock::time_point time;
+            uint64_t bytes_acked = 0;
+            uint64_t bytes_received = 0;
+            size_t send_buffer = 0;
+            size_t receive_buffer = 0;
+        };
+
+        struct connections : public std::vector<connection>, public lockable<std::mutex>
+        {
+        };
+
+        socket_buffer_tuner_options options_;
+        connections connections_;
+        detail::periodic_worker worker_;
+    };
+}
@@ -54,7 +54,7 @@ namespace exa
                     try
                     {
                         auto&& r = std::invoke(f);
-                        p->set_value(r);
+                        p->set_value(std::forward<decltype(r)>(r));
                     }
                     catch (...)
                     {
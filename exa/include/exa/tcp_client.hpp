@@ -18,6 +18,7 @@ namespace exa
         tcp_client();
         tcp_client(const tcp_client&) = delete;
         explicit tcp_client(address_family family);
+        // Binding to port zero leaves picking the port to connect where supported.
         explicit tcp_client(const endpoint& local_ep);
         tcp_client(const address& addr, uint16_t port);
         tcp_client(const std::string& host, uint16_t port);
@@ -32,6 +33,9 @@ namespace exa
         void reuse_address(bool value);
         linger_option linger_state() const;
         void linger_state(const linger_option& value);
+        // Resets the connection on close instead of leaving it in TIME_WAIT.
+        bool abortive_close() const;
+        void abortive_close(bool value);
         bool no_delay() const;
         void no_delay(bool value);
         size_t send_buffer() const;
@@ -42,11 +46,14 @@ namespace exa
         void send_timeout(const std::chrono::milliseconds& value);
         std::chrono::milliseconds receive_timeout() const;
         void receive_timeout(const std::chrono::milliseconds& value);
+        socket_tcp_info tcp_info() const;
         const std::shared_ptr<socket>& socket() const;
 
         void close();
         void connect(const endpoint& remote_ep);
         std::future<void> connect_async(const endpoint& remote_ep);
+        size_t connect(const endpoint& remote_ep, gsl::span<const uint8_t> data);
+        std::future<size_t> connect_async(const endpoint& remote_ep, gsl::span<const uint8_t> data);
         void connect(const address& addr, uint16_t port);
         std::future<void> connect_async(const address& addr, uint16_t port);
         void connect(const std::string& host, uint16_t port);
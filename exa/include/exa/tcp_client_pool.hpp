@@ -0,0 +1,66 @@
+#pragma once
+
+#include <exa/endpoint.hpp>
+#include <exa/tcp_client.hpp>
+#include <exa/concepts.hpp>
+#include <exa/periodic_worker.hpp>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    struct tcp_client_pool_options
+    {
+        // Idle connections kept per endpoint, warm and maintain connect up to min_idle.
+        size_t min_idle = 0;
+        size_t max_idle = 8;
+        // Leased, idle and connecting connections per endpoint, zero disables the limit.
+        size_t max_connections = 0;
+        // Idle connections above min_idle are closed after this long.
+        std::chrono::milliseconds idle_timeout = std::chrono::seconds(60);
+        // Ephemeral ports for new connections, e.g. a shard of the system range per worker process.
+        port_range local_port_range;
+        // Resets closed connections, so they don't hold a port in TIME_WAIT.
+        bool abortive_close = false;
+    };
+
+    // Reuses connected clients per endpoint instead of paying a handshake and a TIME_WAIT entry per request.
+    class tcp_client_pool
+    {
+    public:
+        explicit tcp_client_pool(const tcp_client_pool_options& options = tcp_client_pool_options());
+        tcp_client_pool(const tcp_client_pool&) = delete;
+        virtual ~tcp_client_pool();
+
+        const tcp_client_pool_options& options() const;
+        size_t idle(const endpoint& ep) const;
+        size_t leased(const endpoint& ep) const;
+        bool running() const;
+
+        // Hands out a live idle connection or connects a new one. The client returns to the pool when the last
+        // reference is dropped, unless it was closed or has unread data. Callers waiting on max_connections are
+        // served in order.
+        std::shared_ptr<tcp_client> acquire(const endpoint& ep);
+        std::shared_ptr<tcp_client> acquire(const endpoint& ep, const std::chrono::milliseconds& timeout);
+
+        // Connects until the endpoint has min_idle idle connections and returns how many were created.
+        size_t warm(const endpoint& ep);
+        // Closes dead idle connections and those idle for longer than idle_timeout, returns how many were closed.
+        size_t evict();
+        void clear();
+
+        // Evicts and warms all known endpoints periodically.
+        void start(const std::chrono::milliseconds& interval);
+        void stop();
+
+    private:
+        struct pool_state;
+
+        std::shared_ptr<pool_state> state_;
+        detail::periodic_worker worker_;
+    };
+}
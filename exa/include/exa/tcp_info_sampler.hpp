@@ -0,0 +1,91 @@
+#pragma once
+
+#include <exa/socket.hpp>
+#include <exa/tcp_client.hpp>
+#include <exa/concepts.hpp>
+#include <exa/periodic_worker.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    // Counts values in power of two buckets, bucket i holds values in [2^(i-1), 2^i).
+    class tcp_info_histogram
+    {
+    public:
+        static constexpr size_t bucket_count = 65;
+
+        void add(uint64_t value);
+        void clear();
+
+        uint64_t count() const;
+        uint64_t min() const;
+        uint64_t max() const;
+        double mean() const;
+        // Upper bound of the bucket holding the given fraction of values, 0 if empty.
+        uint64_t percentile(double fraction) const;
+        const std::array<uint64_t, bucket_count>& buckets() const;
+
+    private:
+        std::array<uint64_t, bucket_count> buckets_ = {0};
+        uint64_t count_ = 0;
+        uint64_t min_ = 0;
+        uint64_t max_ = 0;
+        double sum_ = 0;
+    };
+
+    struct tcp_info_statistics
+    {
+        size_t samples = 0;
+        // Microseconds.
+        tcp_info_histogram rtt;
+        tcp_info_histogram retransmits;
+        // Segments.
+        tcp_info_histogram congestion_window;
+        // Bytes per second.
+        tcp_info_histogram pacing_rate;
+        tcp_info_histogram bytes_in_flight;
+    };
+
+    class tcp_info_sampler
+    {
+    public:
+        tcp_info_sampler() = default;
+        tcp_info_sampler(const tcp_info_sampler&) = delete;
+        virtual ~tcp_info_sampler();
+
+        size_t size() const;
+        bool running() const;
+
+        // Connections are held weakly, closed or destroyed ones are dropped on the next sample.
+        void add(const std::shared_ptr<socket>& s);
+        void add(const std::shared_ptr<tcp_client>& c);
+        void remove(const std::shared_ptr<socket>& s);
+
+        // Snapshots every live connection once and returns how many were sampled.
+        size_t sample();
+        tcp_info_statistics statistics() const;
+        void clear();
+
+        void start(const std::chrono::milliseconds& interval);
+        void stop();
+
+    private:
+        struct connections : public std::vector<std::weak_ptr<socket>>, public lockable<std::mutex>
+        {
+        };
+
+        struct aggregate : public tcp_info_statistics, public lockable<std::mutex>
+        {
+        };
+
+        connections connections_;
+        aggregate statistics_;
+        detail::periodic_worker worker_;
+    };
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <exa/buffer_pool.hpp>
 #include <exa/socket.hpp>
 #include <exa/tcp_client.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <future>
 #include <vector>
@@ -12,16 +15,63 @@
 
 namespace exa
 {
+    enum class tcp_shed_mode
+    {
+        // Leaves connections in the backlog until they can be admitted.
+        pause,
+        // Accepts and resets connections that can't be admitted.
+        reject
+    };
+
+    struct tcp_admission_options
+    {
+        // Zero disables a limit. Accepted connections count as live until their client or socket is destroyed.
+        size_t max_live_connections = 0;
+        // Connections per second with bursts of up to accept_burst connections.
+        double max_accept_rate = 0;
+        size_t accept_burst = 64;
+        // Sheds load while the latency given to report_latency stays above the target.
+        std::chrono::microseconds latency_target{0};
+        tcp_shed_mode shed_mode = tcp_shed_mode::pause;
+    };
+
+    struct tcp_admission_counters
+    {
+        size_t live = 0;
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+        // Times accepting was put off because a limit was reached.
+        uint64_t deferred = 0;
+        // Connections dropped because an accept queue was full, the kernel only counts them system-wide.
+        uint64_t backlog_overflows = 0;
+    };
+
+    class unix_client;
+
+    struct tcp_first_read
+    {
+        std::shared_ptr<tcp_client> client;
+        buffer_pool::buffer buffer;
+        // Zero if the peer closed the connection without sending anything or nothing arrived in time.
+        size_t size = 0;
+        // Nothing arrived within the timeout, the client is still connected and can be read from later.
+        bool timed_out = false;
+    };
+
     class tcp_listener
     {
     public:
         static constexpr size_t max_connections = 0x7fffffff;
+        static constexpr size_t accept_batch_size = 64;
+        static constexpr std::chrono::milliseconds first_read_timeout{5000};
 
         tcp_listener() = delete;
         tcp_listener(const tcp_listener&) = delete;
         explicit tcp_listener(uint16_t port);
         tcp_listener(const address& addr, uint16_t port);
         explicit tcp_listener(const endpoint& ep);
+        // Takes over a socket that is already listening.
+        explicit tcp_listener(const std::shared_ptr<exa::socket>& s);
         virtual ~tcp_listener();
 
         bool active() const;
@@ -29,23 +79,64 @@ namespace exa
         void exclusive_address_use(bool value);
         bool reuse_address() const;
         void reuse_address(bool value);
+        bool reuse_port() const;
+        void reuse_port(bool value);
+        size_t fast_open() const;
+        void fast_open(size_t queue_length);
+        // Only completes connections once data arrived or the timeout elapsed, zero disables it.
+        std::chrono::seconds defer_accept() const;
+        void defer_accept(const std::chrono::seconds& timeout);
         endpoint local_endpoint() const;
         const std::shared_ptr<socket>& socket() const;
+        tcp_admission_options admission() const;
+        void admission(const tcp_admission_options& options);
+        tcp_admission_counters counters() const;
+        // Feeds the latency of the application's handler queue into latency based shedding.
+        void report_latency(const std::chrono::microseconds& latency);
+        // Time until pause mode admits the next connection, max if that waits for a live connection to close.
+        std::chrono::steady_clock::duration admission_delay() const;
 
         std::shared_ptr<exa::socket> accept_socket() const;
         std::future<std::shared_ptr<exa::socket>> accept_socket_async() const;
         std::shared_ptr<tcp_client> accept_client() const;
         std::future<std::shared_ptr<tcp_client>> accept_client_async() const;
+        std::vector<std::shared_ptr<tcp_client>> accept_clients(size_t max_count = accept_batch_size) const;
+        std::future<std::vector<std::shared_ptr<tcp_client>>> accept_clients_async(
+            size_t max_count = accept_batch_size) const;
+        // Reads the first chunk sent by the new client into a buffer from the pool, the pool must outlive the future.
+        // Waits at most timeout for the chunk after accepting, so a silent client can't hold up the caller.
+        tcp_first_read accept_client_with_data(buffer_pool& pool,
+                                               const std::chrono::milliseconds& timeout = first_read_timeout) const;
+        std::future<tcp_first_read> accept_client_with_data_async(
+            buffer_pool& pool, const std::chrono::milliseconds& timeout = first_read_timeout) const;
+        // Accepts pending connections like accept_batch, but only as many as admission allows.
+        std::vector<std::shared_ptr<exa::socket>> accept_sockets(size_t max_count = accept_batch_size) const;
 
         bool pending() const;
         void start(size_t backlog = 0x7fffffff);
         void stop();
+        // Passes the listening socket to a successor process and stops listening here. Connections waiting in
+        // the backlog stay queued for the successor instead of being reset.
+        void hand_off(unix_client& successor);
 
         static std::shared_ptr<tcp_listener> create(uint16_t port);
+        // Receives a listening socket passed with hand_off.
+        static std::shared_ptr<tcp_listener> adopt(unix_client& predecessor);
 
     private:
+        struct admission_state;
+
+        size_t allowance(size_t max_count) const;
+        bool paused(bool& deferred) const;
+        std::shared_ptr<exa::socket> admit(const std::shared_ptr<exa::socket>& s) const;
+        std::shared_ptr<exa::socket> try_accept(bool& deferred) const;
+        void reject(const std::shared_ptr<exa::socket>& s) const;
+
         endpoint endpoint_;
         std::shared_ptr<exa::socket> socket_;
+        std::shared_ptr<admission_state> admission_;
+        size_t fast_open_ = 0;
+        std::chrono::seconds defer_accept_{0};
         bool active_ = false;
     };
 }
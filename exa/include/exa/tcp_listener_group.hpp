@@ -0,0 +1,63 @@
+#pragma once
+
+#include <exa/tcp_listener.hpp>
+#include <exa/poller.hpp>
+
+#include <atomic>
+#include <system_error>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    // Listens with one SO_REUSEPORT socket per shard on the same endpoint, the kernel spreads connections across them.
+    class tcp_listener_group
+    {
+    public:
+        using accept_handler = std::function<void(size_t shard, const std::shared_ptr<tcp_client>& client)>;
+        using error_handler = std::function<void(size_t shard, const std::error_code& ec)>;
+
+        tcp_listener_group() = delete;
+        tcp_listener_group(const tcp_listener_group&) = delete;
+        explicit tcp_listener_group(const endpoint& ep, size_t shards = std::thread::hardware_concurrency());
+        virtual ~tcp_listener_group();
+
+        bool active() const;
+        size_t size() const;
+        // Connections received on CPU c go to shard c % size and each shard thread is pinned to the CPUs it serves.
+        bool cpu_steering() const;
+        void cpu_steering(bool value);
+        endpoint local_endpoint() const;
+        const std::shared_ptr<tcp_listener>& listener(size_t shard) const;
+
+        // Accepting is left to the caller through listener().
+        void start(size_t backlog = tcp_listener::max_connections);
+        // Runs an accept loop on its own thread per shard that hands every client to the handler.
+        void start(const accept_handler& handler, size_t backlog = tcp_listener::max_connections);
+        // Like above, accept failures other than running out of descriptors also go to failed before the retry.
+        void start(const accept_handler& handler, const error_handler& failed,
+                   size_t backlog = tcp_listener::max_connections);
+        void stop();
+
+    private:
+        struct shard
+        {
+            std::shared_ptr<tcp_listener> listener;
+            std::unique_ptr<poller> poller;
+            std::thread thread;
+        };
+
+        void run(size_t index, const accept_handler& handler, const error_handler& failed);
+
+        endpoint endpoint_;
+        size_t size_;
+        std::vector<shard> shards_;
+        std::atomic_bool run_{false};
+        bool cpu_steering_ = false;
+        bool active_ = false;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <exa/tcp_listener.hpp>
+#include <exa/poller.hpp>
+#include <exa/concepts.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    class tcp_server;
+
+    class tcp_connection : public std::enable_shared_from_this<tcp_connection>, public lockable<std::mutex>
+    {
+    public:
+        tcp_connection(const tcp_connection&) = delete;
+        virtual ~tcp_connection() = default;
+
+        bool closed() const;
+        endpoint remote_endpoint() const;
+        const std::shared_ptr<exa::socket>& socket() const;
+        size_t pending_output() const;
+
+        // Sends right away if possible, the rest is queued until the socket is writable. Thread safe.
+        void send(gsl::span<const uint8_t> data);
+        // Closes on the connection's I/O loop, queued output is dropped. Thread safe.
+        void close();
+
+        // Released together with the connection.
+        std::shared_ptr<void> user_data;
+
+    private:
+        struct io_loop;
+
+        tcp_connection(const std::shared_ptr<exa::socket>& s, io_loop* loop);
+        void request_close(const std::error_code& ec);
+
+        std::shared_ptr<exa::socket> socket_;
+        endpoint remote_endpoint_;
+        io_loop* loop_;
+        std::vector<uint8_t> output_;
+        size_t output_offset_ = 0;
+        std::error_code error_;
+        bool closing_ = false;
+        bool closed_ = false;
+
+        friend class tcp_server;
+    };
+
+    struct tcp_server_handlers
+    {
+        std::function<void(const std::shared_ptr<tcp_connection>& c)> connected;
+        // Called with data read into the buffer of the I/O loop, which is only valid during the call.
+        std::function<void(const std::shared_ptr<tcp_connection>& c, gsl::span<const uint8_t> data)> received;
+        // Replaces reading by the server, the handler reads from the non-blocking socket itself.
+        std::function<void(const std::shared_ptr<tcp_connection>& c)> readable;
+        // An empty error code means the peer closed the connection or close was called.
+        std::function<void(const std::shared_ptr<tcp_connection>& c, const std::error_code& ec)> disconnected;
+        // Accepting failed for another reason than running out of descriptors, the server retries after a pause.
+        std::function<void(const std::error_code& ec)> accept_failed;
+    };
+
+    struct tcp_server_options
+    {
+        size_t io_loops = std::max(1u, std::thread::hardware_concurrency());
+        size_t read_buffer_size = 64 * 1024;
+        size_t backlog = tcp_listener::max_connections;
+    };
+
+    // Accepts on its own thread and spreads connections across I/O loops, each one a thread with a poller.
+    class tcp_server
+    {
+    public:
+        tcp_server() = delete;
+        tcp_server(const tcp_server&) = delete;
+        tcp_server(const endpoint& ep, const tcp_server_handlers& handlers,
+                   const tcp_server_options& options = tcp_server_options());
+        // Serves a listener that may already be listening, e.g. one adopted from a predecessor.
+        tcp_server(const std::shared_ptr<tcp_listener>& listener, const tcp_server_handlers& handlers,
+                   const tcp_server_options& options = tcp_server_options());
+        virtual ~tcp_server();
+
+        bool active() const;
+        size_t connections() const;
+        endpoint local_endpoint() const;
+        const std::shared_ptr<tcp_listener>& listener() const;
+
+        void start();
+        // Closes all connections and waits for the I/O loops to finish.
+        void stop();
+        // Stops accepting and passes the listening socket to a successor, existing connections are served until
+        // they close or stop is called.
+        void hand_off(unix_client& successor);
+
+    private:
+        using io_loop = tcp_connection::io_loop;
+
+        void stop_accepting();
+        void accept_loop();
+        void run(io_loop& loop);
+        void on_readable(io_loop& loop, const std::shared_ptr<tcp_connection>& c);
+        void on_writable(io_loop& loop, const std::shared_ptr<tcp_connection>& c);
+        void close(io_loop& loop, const std::shared_ptr<tcp_connection>& c, const std::error_code& ec);
+
+        tcp_server_handlers handlers_;
+        tcp_server_options options_;
+        std::shared_ptr<tcp_listener> listener_;
+        std::unique_ptr<poller> accept_poller_;
+        std::vector<std::unique_ptr<io_loop>> loops_;
+        std::thread accept_thread_;
+        std::atomic_size_t connections_{0};
+        std::atomic_bool run_{false};
+        std::atomic_bool accepting_{false};
+        size_t next_loop_ = 0;
+    };
+}
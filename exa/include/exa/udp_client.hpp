@@ -1,6 +1,7 @@
 #pragma once
 
 #include <exa/socket.hpp>
+#include <exa/buffer_pool.hpp>
 
 #include <memory>
 #include <future>
@@ -8,6 +9,7 @@
 #include <string>
 #include <cstdint>
 #include <cstddef>
+#include <iterator>
 
 namespace exa
 {
@@ -15,6 +17,71 @@ namespace exa
     {
         std::vector<uint8_t> buffer;
         endpoint endpoint;
+        // Full datagram length, larger than the buffer if the rest of the datagram got discarded.
+        size_t size = 0;
+    };
+
+    struct udp_datagram
+    {
+        // The received part of the datagram inside the caller's buffer.
+        gsl::span<const uint8_t> data;
+        size_t size = 0;
+
+        bool truncated() const;
+    };
+
+    struct udp_receive_datagram_result
+    {
+        udp_datagram datagram;
+        endpoint endpoint;
+    };
+
+    class udp_segments
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = gsl::span<const uint8_t>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = value_type;
+
+            const_iterator(const udp_segments& segments, size_t index);
+
+            value_type operator*() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            bool operator==(const const_iterator& other) const;
+            bool operator!=(const const_iterator& other) const;
+
+        private:
+            const udp_segments* segments_;
+            size_t index_;
+        };
+
+        udp_segments() = default;
+        udp_segments(gsl::span<const uint8_t> buffer, size_t segment_size);
+
+        bool empty() const;
+        size_t size() const;
+        size_t bytes() const;
+        size_t segment_size() const;
+        gsl::span<const uint8_t> buffer() const;
+        gsl::span<const uint8_t> operator[](size_t index) const;
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        gsl::span<const uint8_t> buffer_;
+        size_t segment_size_ = 0;
+    };
+
+    struct udp_receive_segments_result
+    {
+        udp_segments segments;
+        endpoint endpoint;
     };
 
     class udp_client
@@ -46,11 +113,31 @@ namespace exa
         void connect(const endpoint& remote_ep);
         void connect(const std::string& host, uint16_t port);
         std::vector<uint8_t> receive(endpoint& ep);
+        std::vector<uint8_t> receive(endpoint& ep, socket_timestamp& timestamp);
         std::future<udp_receive_result> receive_async();
+        // Receive into the given buffer without allocating, datagrams larger than the buffer are truncated.
+        udp_datagram receive(gsl::span<uint8_t> buffer, endpoint& ep);
+        std::future<udp_receive_datagram_result> receive_async(gsl::span<uint8_t> buffer);
+        // The result buffer comes from the pool, hand it back with release once it's processed.
+        std::future<udp_receive_result> receive_async(buffer_pool& pool);
         size_t send(gsl::span<const uint8_t> buffer);
         std::future<size_t> send_async(gsl::span<const uint8_t> buffer);
         size_t send(gsl::span<const uint8_t> buffer, const endpoint& ep);
         std::future<size_t> send_async(gsl::span<const uint8_t> buffer, const endpoint& ep);
+        bool timestamping() const;
+        void timestamping(bool value);
+        bool receive_offload() const;
+        void receive_offload(bool value);
+        size_t send_segments(gsl::span<const uint8_t> buffer, size_t segment_size);
+        std::future<size_t> send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size);
+        size_t send_segments(gsl::span<const uint8_t> buffer, size_t segment_size, const endpoint& ep);
+        std::future<size_t> send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size, const endpoint& ep);
+        udp_segments receive_segments(gsl::span<uint8_t> buffer, endpoint& ep);
+        std::future<udp_receive_segments_result> receive_segments_async(gsl::span<uint8_t> buffer);
+        size_t receive_batch(gsl::span<socket_receive_message> messages);
+        std::future<size_t> receive_batch_async(gsl::span<socket_receive_message> messages);
+        size_t send_batch(gsl::span<const socket_send_message> messages);
+        std::future<size_t> send_batch_async(gsl::span<const socket_send_message> messages);
 
     private:
         static constexpr size_t max_udp_size = 0x10000;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <exa/socket.hpp>
+#include <exa/network_stream.hpp>
+
+#include <memory>
+#include <future>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    class unix_client
+    {
+    public:
+        unix_client();
+        unix_client(const unix_client&) = delete;
+        explicit unix_client(const std::shared_ptr<exa::socket>& s);
+        virtual ~unix_client() = default;
+
+        bool connected() const;
+        size_t available() const;
+        size_t send_buffer() const;
+        void send_buffer(size_t value);
+        size_t receive_buffer() const;
+        void receive_buffer(size_t value);
+        std::chrono::milliseconds send_timeout() const;
+        void send_timeout(const std::chrono::milliseconds& value);
+        std::chrono::milliseconds receive_timeout() const;
+        void receive_timeout(const std::chrono::milliseconds& value);
+        const std::shared_ptr<socket>& socket() const;
+
+        void close();
+        void connect(const endpoint& remote_ep);
+        std::future<void> connect_async(const endpoint& remote_ep);
+        void connect(const std::string& path);
+        std::future<void> connect_async(const std::string& path);
+        size_t send_descriptors(gsl::span<const socket::native_handle_type> descriptors,
+                                gsl::span<const uint8_t> data);
+        size_t receive_descriptors(gsl::span<uint8_t> buffer, std::vector<socket::native_handle_type>& descriptors);
+        const std::shared_ptr<network_stream>& stream();
+
+    private:
+        std::shared_ptr<exa::socket> socket_;
+        std::shared_ptr<exa::network_stream> stream_;
+    };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <exa/socket.hpp>
+#include <exa/unix_client.hpp>
+
+#include <memory>
+#include <future>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace exa
+{
+    class unix_listener
+    {
+    public:
+        static constexpr size_t max_connections = 0x7fffffff;
+
+        unix_listener() = delete;
+        unix_listener(const unix_listener&) = delete;
+        explicit unix_listener(const std::string& path);
+        explicit unix_listener(const endpoint& ep);
+        virtual ~unix_listener();
+
+        bool active() const;
+        endpoint local_endpoint() const;
+        const std::shared_ptr<socket>& socket() const;
+
+        std::shared_ptr<exa::socket> accept_socket() const;
+        std::future<std::shared_ptr<exa::socket>> accept_socket_async() const;
+        std::shared_ptr<unix_client> accept_client() const;
+        std::future<std::shared_ptr<unix_client>> accept_client_async() const;
+
+        bool pending() const;
+        void start(size_t backlog = 0x7fffffff);
+        // Removes the socket file of path endpoints again.
+        void stop();
+
+    private:
+        endpoint endpoint_;
+        std::shared_ptr<exa::socket> socket_;
+        bool active_ = false;
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <exa/tcp_listener.hpp>
+#include <exa/poller.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+namespace exa
+{
+    namespace detail
+    {
+        // One round of an accept loop that waits for a non-blocking listener on a poller.
+        class accept_round
+        {
+        public:
+            using error_handler = std::function<void(const std::error_code& ec)>;
+
+            // How long the listener is left unwatched when descriptors or buffers ran out or accepting failed. Also
+            // bounds a pause by admission, which otherwise lasts until the next token or the latency report expires.
+            static constexpr std::chrono::milliseconds backoff{50};
+
+            // Accepts what admission allows. Failures other than a connection that went away before it got accepted
+            // go to the handler, except running out of descriptors or buffers which only backs off. Backing off takes
+            // the listener off the poller, a notify on the poller ends it early.
+            static std::vector<std::shared_ptr<socket>> run(const tcp_listener& listener, poller& p,
+                                                            const error_handler& failed);
+        };
+    }
+}
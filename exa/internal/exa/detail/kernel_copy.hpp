@@ -0,0 +1,17 @@
+#pragma once
+
+#include <exa/stream.hpp>
+
+namespace exa
+{
+    namespace detail
+    {
+        class kernel_copy
+        {
+        public:
+            // Copies the rest of from into to without passing the data through user space. Returns false if the
+            // streams or the kernel don't support it, the remaining data then has to be copied by the caller.
+            static bool run(stream& from, stream& to, std::streamsize buffer_size);
+        };
+    }
+}
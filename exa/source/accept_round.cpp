@@ -0,0 +1,76 @@
+#include <exa/detail/accept_round.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace exa
+{
+    namespace detail
+    {
+        namespace
+        {
+            bool nothing_to_accept(const std::error_code& ec)
+            {
+                return ec == std::errc::connection_aborted || ec == std::errc::resource_unavailable_try_again ||
+                       ec == std::errc::operation_would_block;
+            }
+
+            bool out_of_resources(const std::error_code& ec)
+            {
+                return ec == std::errc::too_many_files_open || ec == std::errc::too_many_files_open_in_system ||
+                       ec == std::errc::no_buffer_space || ec == std::errc::not_enough_memory;
+            }
+        }
+
+        std::vector<std::shared_ptr<socket>> accept_round::run(const tcp_listener& listener, poller& p,
+                                                               const error_handler& failed)
+        {
+            std::vector<std::shared_ptr<socket>> sockets;
+            auto idle = std::chrono::milliseconds::zero();
+
+            try
+            {
+                sockets = listener.accept_sockets();
+
+                if (sockets.empty())
+                {
+                    // Admission paused accepting, the backlog stays readable until it resumes.
+                    auto delay = std::min<std::chrono::steady_clock::duration>(listener.admission_delay(), backoff);
+                    idle = std::chrono::ceil<std::chrono::milliseconds>(delay);
+                }
+            }
+            catch (const std::system_error& e)
+            {
+                if (nothing_to_accept(e.code()))
+                {
+                    return sockets;
+                }
+
+                // The listener stays readable while the backlog is full, retrying at once would only spin.
+                if (!out_of_resources(e.code()) && failed)
+                {
+                    try
+                    {
+                        failed(e.code());
+                    }
+                    catch (const std::exception&)
+                    {
+                        // A failing handler must not end the accept loop.
+                    }
+                }
+
+                idle = backoff;
+            }
+
+            if (idle > std::chrono::milliseconds::zero())
+            {
+                std::array<poll_event, 1> events;
+                p.remove(listener.socket());
+                p.wait(events, idle);
+                p.add(listener.socket(), poll_events::read);
+            }
+
+            return sockets;
+        }
+    }
+}
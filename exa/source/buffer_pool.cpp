@@ -0,0 +1,62 @@
+#include <exa/buffer_pool.hpp>
+
+#include <stdexcept>
+
+namespace exa
+{
+    buffer_pool::buffer_pool(size_t buffer_size, size_t max_free) : buffer_size_(buffer_size), max_free_(max_free)
+    {
+        if (buffer_size == 0)
+        {
+            throw std::out_of_range("Buffer size must be greater than 0.");
+        }
+    }
+
+    size_t buffer_pool::buffer_size() const
+    {
+        return buffer_size_;
+    }
+
+    size_t buffer_pool::max_free() const
+    {
+        return max_free_;
+    }
+
+    size_t buffer_pool::available() const
+    {
+        size_t n = 0;
+        lock(free_, [&] { n = free_.size(); });
+        return n;
+    }
+
+    buffer_pool::buffer buffer_pool::acquire()
+    {
+        buffer b;
+
+        lock(free_, [&] {
+            if (!free_.empty())
+            {
+                b = std::move(free_.back());
+                free_.pop_back();
+            }
+        });
+
+        b.resize(buffer_size_);
+        return b;
+    }
+
+    void buffer_pool::release(buffer&& b)
+    {
+        if (b.capacity() < buffer_size_)
+        {
+            return;
+        }
+
+        lock(free_, [&] {
+            if (free_.size() < max_free_)
+            {
+                free_.push_back(std::move(b));
+            }
+        });
+    }
+}
@@ -0,0 +1,589 @@
+#include <exa/dns_resolver.hpp>
+#include <exa/udp_client.hpp>
+#include <exa/task.hpp>
+#include <exa/concepts.hpp>
+#include <exa/detail/io_task.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    namespace
+    {
+        constexpr uint16_t dns_port = 53;
+        constexpr uint16_t dns_type_a = 1;
+        constexpr uint16_t dns_type_soa = 6;
+        constexpr uint16_t dns_type_aaaa = 28;
+        constexpr uint16_t dns_class_in = 1;
+        constexpr uint16_t dns_rcode_no_error = 0;
+        constexpr uint16_t dns_rcode_name_error = 3;
+        constexpr size_t dns_header_size = 12;
+        constexpr size_t max_dns_name_size = 255;
+        constexpr size_t max_dns_label_size = 63;
+
+        using clock = std::chrono::steady_clock;
+
+        struct dns_answer
+        {
+            uint16_t rcode = dns_rcode_no_error;
+            std::vector<address> addresses;
+            std::chrono::seconds ttl = std::chrono::seconds::max();
+        };
+
+        std::string normalize_host(const std::string& host)
+        {
+            std::string result(host);
+            std::transform(std::begin(result), std::end(result), std::begin(result),
+                           [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+            if (!result.empty() && result.back() == '.')
+            {
+                result.pop_back();
+            }
+
+            return result;
+        }
+
+        uint16_t read_uint16(gsl::span<const uint8_t> data, size_t offset)
+        {
+            if (offset + 2 > static_cast<size_t>(data.size()))
+            {
+                throw std::runtime_error("DNS message is truncated.");
+            }
+
+            return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+        }
+
+        uint32_t read_uint32(gsl::span<const uint8_t> data, size_t offset)
+        {
+            return (static_cast<uint32_t>(read_uint16(data, offset)) << 16) | read_uint16(data, offset + 2);
+        }
+
+        void write_uint16(std::vector<uint8_t>& data, uint16_t value)
+        {
+            data.push_back(static_cast<uint8_t>(value >> 8));
+            data.push_back(static_cast<uint8_t>(value & 0xff));
+        }
+
+        size_t skip_name(gsl::span<const uint8_t> data, size_t offset)
+        {
+            while (true)
+            {
+                if (offset >= static_cast<size_t>(data.size()))
+                {
+                    throw std::runtime_error("DNS message is truncated.");
+                }
+
+                auto length = data[offset];
+
+                if ((length & 0xc0) == 0xc0)
+                {
+                    return offset + 2;
+                }
+                if (length == 0)
+                {
+                    return offset + 1;
+                }
+
+                offset += length + 1;
+            }
+        }
+
+        std::vector<uint8_t> build_query(uint16_t id, const std::string& host, uint16_t type)
+        {
+            if (host.empty() || host.size() > max_dns_name_size)
+            {
+                throw std::invalid_argument("Host name has invalid length.");
+            }
+
+            std::vector<uint8_t> query;
+            query.reserve(dns_header_size + host.size() + 6);
+            write_uint16(query, id);
+            write_uint16(query, 0x0100);
+            write_uint16(query, 1);
+            write_uint16(query, 0);
+            write_uint16(query, 0);
+            write_uint16(query, 0);
+
+            size_t first = 0;
+
+            while (first <= host.size())
+            {
+                auto last = std::min(host.find('.', first), host.size());
+                auto length = last - first;
+
+                if (length == 0 || length > max_dns_label_size)
+                {
+                    throw std::invalid_argument("Host name contains an invalid label.");
+                }
+
+                query.push_back(static_cast<uint8_t>(length));
+                query.insert(std::end(query), std::next(std::begin(host), first), std::next(std::begin(host), last));
+                first = last + 1;
+            }
+
+            query.push_back(0);
+            write_uint16(query, type);
+            write_uint16(query, dns_class_in);
+            return query;
+        }
+
+        dns_answer parse_response(gsl::span<const uint8_t> data, uint16_t type)
+        {
+            dns_answer answer;
+            auto flags = read_uint16(data, 2);
+
+            if ((flags & 0x8000) == 0)
+            {
+                throw std::runtime_error("DNS message isn't a response.");
+            }
+
+            answer.rcode = flags & 0x000f;
+            auto question_count = read_uint16(data, 4);
+            auto answer_count = read_uint16(data, 6);
+            auto authority_count = read_uint16(data, 8);
+            auto offset = dns_header_size;
+
+            for (uint16_t i = 0; i < question_count; ++i)
+            {
+                offset = skip_name(data, offset) + 4;
+            }
+
+            for (uint32_t i = 0; i < static_cast<uint32_t>(answer_count) + authority_count; ++i)
+            {
+                offset = skip_name(data, offset);
+                auto record_type = read_uint16(data, offset);
+                auto record_class = read_uint16(data, offset + 2);
+                auto ttl = std::chrono::seconds(read_uint32(data, offset + 4));
+                auto length = read_uint16(data, offset + 8);
+                offset += 10;
+
+                if (offset + length > static_cast<size_t>(data.size()))
+                {
+                    throw std::runtime_error("DNS message is truncated.");
+                }
+
+                auto rdata = data.subspan(static_cast<std::ptrdiff_t>(offset), length);
+                offset += length;
+
+                if (record_class != dns_class_in)
+                {
+                    continue;
+                }
+
+                if (i < answer_count && record_type == type)
+                {
+                    if (type == dns_type_a && length == 4)
+                    {
+                        answer.addresses.emplace_back(read_uint32(rdata, 0));
+                    }
+                    else if (type == dns_type_aaaa && length == 16)
+                    {
+                        answer.addresses.emplace_back(rdata);
+                    }
+                    else
+                    {
+                        continue;
+                    }
+
+                    answer.ttl = std::min(answer.ttl, ttl);
+                }
+                else if (i >= answer_count && record_type == dns_type_soa && answer.addresses.empty())
+                {
+                    auto minimum_offset = skip_name(rdata, skip_name(rdata, 0)) + 16;
+                    auto minimum = std::chrono::seconds(read_uint32(rdata, minimum_offset));
+                    answer.ttl = std::min(ttl, minimum);
+                }
+            }
+
+            return answer;
+        }
+
+        std::unordered_map<std::string, std::vector<address>> read_hosts(const std::string& path)
+        {
+            std::unordered_map<std::string, std::vector<address>> hosts;
+            std::ifstream file(path);
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                line = line.substr(0, line.find('#'));
+                std::istringstream tokens(line);
+                std::string ip;
+                address addr;
+
+                if (!(tokens >> ip) || !address::try_parse(ip, addr))
+                {
+                    continue;
+                }
+
+                for (std::string name; tokens >> name;)
+                {
+                    hosts[normalize_host(name)].push_back(addr);
+                }
+            }
+
+            return hosts;
+        }
+
+        std::vector<endpoint> read_name_servers(const std::string& path)
+        {
+            std::vector<endpoint> servers;
+            std::ifstream file(path);
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                std::istringstream tokens(line);
+                std::string keyword;
+                std::string ip;
+                address addr;
+
+                if (tokens >> keyword >> ip && keyword == "nameserver" && address::try_parse(ip, addr))
+                {
+                    servers.emplace_back(addr, dns_port);
+                }
+            }
+
+            if (servers.empty())
+            {
+                servers.emplace_back(address::loopback, dns_port);
+            }
+
+            return servers;
+        }
+
+        bool same_endpoint(const endpoint& a, const endpoint& b)
+        {
+            return a.port() == b.port() && a.address().bytes() == b.address().bytes();
+        }
+    }
+
+    struct dns_resolver::resolver_state
+    {
+        struct cache_entry
+        {
+            std::vector<address> addresses;
+            clock::time_point expires;
+        };
+
+        struct cache : public std::unordered_map<std::string, cache_entry>, public lockable<std::mutex>
+        {
+            std::unordered_map<std::string, std::shared_future<std::vector<address>>> pending;
+        };
+
+        dns_resolver_options options;
+        std::unordered_map<std::string, std::vector<address>> hosts;
+        cache entries;
+        std::mt19937 random{std::random_device()()};
+
+        uint16_t next_id()
+        {
+            return static_cast<uint16_t>(random());
+        }
+
+        void store(const std::string& host, std::vector<address> addresses, std::chrono::seconds ttl)
+        {
+            auto now = clock::now();
+
+            if (entries.size() >= options.cache_size)
+            {
+                for (auto it = std::begin(entries); it != std::end(entries);)
+                {
+                    it = it->second.expires <= now ? entries.erase(it) : std::next(it);
+                }
+            }
+            if (entries.size() >= options.cache_size && !entries.empty())
+            {
+                entries.erase(std::min_element(std::begin(entries), std::end(entries), [](auto&& a, auto&& b) {
+                    return a.second.expires < b.second.expires;
+                }));
+            }
+
+            entries[host] = cache_entry{std::move(addresses), now + std::min(ttl, options.max_ttl)};
+        }
+    };
+
+    namespace
+    {
+        struct dns_query
+        {
+            struct question
+            {
+                uint16_t type = 0;
+                uint16_t id = 0;
+                bool answered = false;
+                dns_answer answer;
+            };
+
+            std::string host;
+            std::vector<question> questions;
+            std::shared_ptr<udp_client> client;
+            size_t attempt = 0;
+            clock::time_point deadline;
+        };
+
+        void send_queries(dns_query& query, const std::vector<endpoint>& servers)
+        {
+            auto& server = servers[query.attempt % servers.size()];
+            query.client = std::make_shared<udp_client>(server.family());
+
+            for (auto& q : query.questions)
+            {
+                if (!q.answered)
+                {
+                    query.client->send(build_query(q.id, query.host, q.type), server);
+                }
+            }
+        }
+    }
+
+    dns_resolver::dns_resolver() : dns_resolver(dns_resolver_options())
+    {
+    }
+
+    dns_resolver::dns_resolver(const dns_resolver_options& options) : state_(std::make_shared<resolver_state>())
+    {
+        if (options.attempts == 0)
+        {
+            throw std::out_of_range("DNS resolver needs at least one attempt.");
+        }
+        if (options.timeout <= 0ms)
+        {
+            throw std::out_of_range("DNS resolver timeout must be greater than 0.");
+        }
+
+        state_->options = options;
+
+        if (state_->options.name_servers.empty())
+        {
+            state_->options.name_servers = read_name_servers(options.resolv_conf_path);
+        }
+        if (options.use_hosts)
+        {
+            state_->hosts = read_hosts(options.hosts_path);
+        }
+    }
+
+    const std::vector<endpoint>& dns_resolver::name_servers() const
+    {
+        return state_->options.name_servers;
+    }
+
+    size_t dns_resolver::cache_entries() const
+    {
+        size_t n = 0;
+        lock(state_->entries, [&] { n = state_->entries.size(); });
+        return n;
+    }
+
+    void dns_resolver::clear_cache()
+    {
+        lock(state_->entries, [this] { state_->entries.clear(); });
+    }
+
+    std::vector<address> dns_resolver::lookup(const std::string& host)
+    {
+        return lookup_async(host).get();
+    }
+
+    std::shared_future<std::vector<address>> dns_resolver::lookup_async(const std::string& host)
+    {
+        auto name = normalize_host(host);
+        address literal;
+
+        if (address::try_parse(name, literal))
+        {
+            std::promise<std::vector<address>> p;
+            p.set_value({literal});
+            return p.get_future().share();
+        }
+
+        auto hosts_entry = state_->hosts.find(name);
+
+        if (hosts_entry != std::end(state_->hosts))
+        {
+            std::promise<std::vector<address>> p;
+            p.set_value(hosts_entry->second);
+            return p.get_future().share();
+        }
+
+        auto state = state_;
+        auto query = std::make_shared<dns_query>();
+        std::shared_future<std::vector<address>> result;
+
+        lock(state->entries, [&] {
+            auto cached = state->entries.find(name);
+
+            if (cached != std::end(state->entries))
+            {
+                if (cached->second.expires > clock::now())
+                {
+                    std::promise<std::vector<address>> p;
+
+                    if (cached->second.addresses.empty())
+                    {
+                        p.set_exception(std::make_exception_ptr(std::runtime_error("Host name doesn't exist.")));
+                    }
+                    else
+                    {
+                        p.set_value(cached->second.addresses);
+                    }
+
+                    result = p.get_future().share();
+                    return;
+                }
+
+                state->entries.erase(cached);
+            }
+
+            auto pending = state->entries.pending.find(name);
+
+            if (pending != std::end(state->entries.pending))
+            {
+                result = pending->second;
+                return;
+            }
+
+            query->host = name;
+
+            if (state->options.family != address_family::inter_network_v6)
+            {
+                query->questions.push_back({dns_type_a, state->next_id()});
+            }
+            if (state->options.family != address_family::inter_network)
+            {
+                query->questions.push_back({dns_type_aaaa, state->next_id()});
+            }
+
+            result = detail::io_task::run<std::vector<address>>([state, query] {
+                auto& servers = state->options.name_servers;
+                auto finish = [&](std::vector<address> addresses, std::chrono::seconds ttl) {
+                    lock(state->entries, [&] {
+                        state->store(query->host, addresses, ttl);
+                        state->entries.pending.erase(query->host);
+                    });
+                };
+
+                try
+                {
+                    if (!query->client)
+                    {
+                        send_queries(*query, servers);
+                        query->deadline = clock::now() + state->options.timeout;
+                    }
+
+                    while (query->client->socket()->poll(0us, select_mode::read))
+                    {
+                        endpoint ep;
+                        auto response = query->client->receive(ep);
+
+                        if (response.size() < dns_header_size ||
+                            !same_endpoint(ep, servers[query->attempt % servers.size()]))
+                        {
+                            continue;
+                        }
+
+                        auto id = read_uint16(response, 0);
+
+                        for (auto& q : query->questions)
+                        {
+                            if (q.answered || q.id != id)
+                            {
+                                continue;
+                            }
+
+                            try
+                            {
+                                q.answer = parse_response(response, q.type);
+                                q.answered = q.answer.rcode == dns_rcode_no_error ||
+                                             q.answer.rcode == dns_rcode_name_error;
+                            }
+                            catch (std::runtime_error&)
+                            {
+                                // Ignore malformed responses and wait for another one.
+                            }
+                        }
+                    }
+
+                    auto answered = std::all_of(std::begin(query->questions), std::end(query->questions),
+                                                [](auto&& q) { return q.answered; });
+
+                    if (answered)
+                    {
+                        std::vector<address> addresses;
+                        auto ttl = std::chrono::seconds::max();
+
+                        for (auto& q : query->questions)
+                        {
+                            addresses.insert(std::end(addresses), std::begin(q.answer.addresses),
+                                             std::end(q.answer.addresses));
+                            ttl = std::min(ttl, q.answer.ttl);
+                        }
+
+                        if (addresses.empty())
+                        {
+                            finish({}, ttl == std::chrono::seconds::max() ? state->options.negative_ttl : ttl);
+                            throw std::runtime_error("Host name doesn't exist.");
+                        }
+
+                        finish(addresses, ttl);
+                        return std::make_tuple(true, addresses);
+                    }
+
+                    if (clock::now() >= query->deadline)
+                    {
+                        query->attempt += 1;
+
+                        if (query->attempt >= state->options.attempts * servers.size())
+                        {
+                            throw std::runtime_error("DNS query timed out.");
+                        }
+
+                        send_queries(*query, servers);
+                        query->deadline = clock::now() + state->options.timeout;
+                    }
+
+                    return std::make_tuple(false, std::vector<address>());
+                }
+                catch (...)
+                {
+                    lock(state->entries, [&] { state->entries.pending.erase(query->host); });
+                    throw;
+                }
+            }).share();
+
+            state->entries.pending.emplace(name, result);
+        });
+
+        return result;
+    }
+
+    std::vector<endpoint> dns_resolver::resolve(const std::string& host, uint16_t port)
+    {
+        return resolve_async(host, port).get();
+    }
+
+    std::future<std::vector<endpoint>> dns_resolver::resolve_async(const std::string& host, uint16_t port)
+    {
+        auto addresses = lookup_async(host);
+
+        return std::async(std::launch::deferred, [addresses, port] {
+            std::vector<endpoint> endpoints;
+
+            for (auto& addr : addresses.get())
+            {
+                endpoints.emplace_back(addr, port);
+            }
+
+            return endpoints;
+        });
+    }
+}
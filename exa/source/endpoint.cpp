@@ -1,5 +1,9 @@
 #include <exa/endpoint.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 namespace exa
 {
     endpoint::endpoint()
@@ -14,10 +18,34 @@ namespace exa
     {
     }
 
-    endpoint::endpoint(const sockaddr_storage& storage)
+    endpoint::endpoint(const sockaddr_storage& storage) : endpoint(storage, sizeof(storage))
+    {
+    }
+
+    endpoint::endpoint(const sockaddr_storage& storage, size_t length)
     {
         switch (storage.ss_family)
         {
+            case AF_UNIX:
+            {
+                auto addr = reinterpret_cast<const sockaddr_un*>(&storage);
+                auto offset = offsetof(sockaddr_un, sun_path);
+                auto n = length > offset ? std::min(length - offset, sizeof(addr->sun_path)) : 0;
+                unix_ = true;
+
+                if (n > 0 && addr->sun_path[0] == '\0')
+                {
+                    // Abstract names may contain null bytes, only an unknown length ends them at the first one.
+                    abstract_ = true;
+                    n = n == sizeof(addr->sun_path) ? strnlen(addr->sun_path + 1, n - 1) + 1 : n;
+                    path_.assign(addr->sun_path + 1, n - 1);
+                }
+                else
+                {
+                    path_.assign(addr->sun_path, strnlen(addr->sun_path, n));
+                }
+                break;
+            }
             case AF_INET:
             {
                 auto addr = reinterpret_cast<const sockaddr_in*>(&storage);
@@ -41,7 +69,7 @@ namespace exa
 
     address_family endpoint::family() const
     {
-        return address_.family();
+        return unix_ ? address_family::unix_descriptor : address_.family();
     }
 
     const address& endpoint::address() const
@@ -54,8 +82,40 @@ namespace exa
         return port_;
     }
 
+    const std::string& endpoint::path() const
+    {
+        return path_;
+    }
+
+    bool endpoint::abstract() const
+    {
+        return abstract_;
+    }
+
     std::vector<uint8_t> endpoint::serialize() const
     {
+        if (unix_)
+        {
+            sockaddr_un storage = {0};
+            auto offset = offsetof(sockaddr_un, sun_path);
+            auto p = reinterpret_cast<uint8_t*>(&storage);
+            storage.sun_family = AF_UNIX;
+
+            if (path_.empty() && !abstract_)
+            {
+                return std::vector<uint8_t>(p, p + offset);
+            }
+
+            // Paths need a terminating null byte, abstract names a leading one instead.
+            if (path_.size() + 1 > sizeof(storage.sun_path))
+            {
+                throw std::invalid_argument("Unix socket path is too long.");
+            }
+
+            memcpy(storage.sun_path + (abstract_ ? 1 : 0), path_.data(), path_.size());
+            return std::vector<uint8_t>(p, p + offset + path_.size() + 1);
+        }
+
         switch (address_.family())
         {
             case address_family::inter_network:
@@ -88,6 +148,33 @@ namespace exa
         }
     }
 
+    endpoint endpoint::unix_path(const std::string& path)
+    {
+        if (path.empty())
+        {
+            throw std::invalid_argument("Unix socket path is empty.");
+        }
+
+        endpoint ep;
+        ep.unix_ = true;
+        ep.path_ = path;
+        return ep;
+    }
+
+    endpoint endpoint::unix_abstract(const std::string& name)
+    {
+        if (name.empty())
+        {
+            throw std::invalid_argument("Abstract unix socket name is empty.");
+        }
+
+        endpoint ep;
+        ep.unix_ = true;
+        ep.abstract_ = true;
+        ep.path_ = name;
+        return ep;
+    }
+
     std::vector<endpoint> endpoint::get_address_info(const std::string& host, const std::string& service)
     {
         addrinfo* iterator = nullptr;
@@ -320,6 +320,12 @@ namespace exa
         validate_descriptor(context_->file);
         return context_->name;
     }
+
+    file_stream::native_handle_type file_stream::native_handle() const
+    {
+        validate_descriptor(context_->file);
+        return context_->file;
+    }
 }
 
 #endif
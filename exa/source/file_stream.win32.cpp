@@ -287,6 +287,12 @@ namespace exa
         validate_handle(context_->file);
         return context_->name;
     }
+
+    file_stream::native_handle_type file_stream::native_handle() const
+    {
+        validate_handle(context_->file);
+        return context_->file;
+    }
 }
 
 #endif
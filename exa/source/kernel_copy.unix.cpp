@@ -0,0 +1,339 @@
+#ifndef _WIN32
+#include <exa/detail/kernel_copy.hpp>
+#include <exa/file_stream.hpp>
+#include <exa/network_stream.hpp>
+
+#include <poll.h>
+#include <sys/sendfile.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace exa
+{
+    namespace detail
+    {
+        namespace
+        {
+            constexpr size_t max_chunk_size = 0x7ffff000;
+
+            // Errors which only tell that the kernel can't copy between these descriptors.
+            bool is_unsupported(int error)
+            {
+                return error == EINVAL || error == ENOSYS || error == EXDEV || error == EOPNOTSUPP;
+            }
+
+            struct stat file_status(int fd)
+            {
+                struct stat s = {0};
+
+                if (fstat(fd, &s) == -1)
+                {
+                    throw std::system_error(errno, std::system_category(), "fstat");
+                }
+
+                return s;
+            }
+
+            off_t file_offset(int fd)
+            {
+                auto pos = lseek(fd, 0, SEEK_CUR);
+
+                if (pos == -1)
+                {
+                    throw std::system_error(errno, std::system_category(), "lseek");
+                }
+
+                return pos;
+            }
+
+            void file_offset(int fd, off_t value)
+            {
+                if (lseek(fd, value, SEEK_SET) == -1)
+                {
+                    throw std::system_error(errno, std::system_category(), "lseek");
+                }
+            }
+
+            void wait(const socket& s, select_mode mode)
+            {
+                if (s.blocking())
+                {
+                    throw std::system_error(errno, std::system_category(), mode == select_mode::read ? "splice" : "sendfile");
+                }
+
+                s.poll(std::chrono::microseconds(-1), mode);
+            }
+
+            // Also used for blocking outputs whose send timeout elapsed, data already in the pipe can't go back.
+            void wait_writable(int fd)
+            {
+                pollfd p = {fd, POLLOUT, 0};
+
+                while (::poll(&p, 1, -1) == -1)
+                {
+                    if (errno != EINTR)
+                    {
+                        throw std::system_error(errno, std::system_category(), "poll");
+                    }
+                }
+            }
+
+            class pipe
+            {
+            public:
+                pipe()
+                {
+                    if (pipe2(fds_.data(), O_CLOEXEC) == -1)
+                    {
+                        throw std::system_error(errno, std::system_category(), "pipe2");
+                    }
+                }
+
+                ~pipe()
+                {
+                    ::close(fds_[0]);
+                    ::close(fds_[1]);
+                }
+
+                int read_end() const
+                {
+                    return fds_[0];
+                }
+
+                int write_end() const
+                {
+                    return fds_[1];
+                }
+
+            private:
+                std::array<int, 2> fds_;
+            };
+
+            bool copy_file_to_file(file_stream& from, file_stream& to)
+            {
+                auto in = from.native_handle();
+                auto out = to.native_handle();
+                auto in_status = file_status(in);
+                auto out_status = file_status(out);
+
+                if (!S_ISREG(in_status.st_mode) || !S_ISREG(out_status.st_mode))
+                {
+                    return false;
+                }
+
+                loff_t src = file_offset(in);
+                loff_t dst = file_offset(out);
+                auto end = static_cast<loff_t>(in_status.st_size);
+
+                // Holes can only be skipped if everything is written past the end of the destination, otherwise
+                // the skipped ranges would keep the old destination content instead of reading back as zeros.
+                auto sparse = dst == static_cast<loff_t>(out_status.st_size);
+                auto supported = true;
+
+                while (src < end && supported)
+                {
+                    auto hole = end;
+
+                    if (sparse)
+                    {
+                        auto data = lseek(in, src, SEEK_DATA);
+
+                        if (data == -1)
+                        {
+                            if (errno != ENXIO)
+                            {
+                                throw std::system_error(errno, std::system_category(), "lseek");
+                            }
+
+                            data = end;
+                        }
+
+                        dst += data - src;
+                        src = data;
+
+                        if (src < end)
+                        {
+                            hole = lseek(in, src, SEEK_HOLE);
+                            hole = hole == -1 ? end : std::min<loff_t>(hole, end);
+                        }
+                    }
+
+                    while (src < hole)
+                    {
+                        auto n = copy_file_range(in, &src, out, &dst,
+                                                 std::min<size_t>(static_cast<size_t>(hole - src), max_chunk_size), 0);
+
+                        if (n == -1)
+                        {
+                            if (!is_unsupported(errno))
+                            {
+                                throw std::system_error(errno, std::system_category(), "copy_file_range");
+                            }
+
+                            supported = false;
+                            break;
+                        }
+                        if (n == 0)
+                        {
+                            // The source was truncated while copying.
+                            end = src;
+                            break;
+                        }
+                    }
+                }
+
+                if (supported && dst > static_cast<loff_t>(file_status(out).st_size) &&
+                    ftruncate(out, static_cast<off_t>(dst)) == -1)
+                {
+                    throw std::system_error(errno, std::system_category(), "ftruncate");
+                }
+
+                file_offset(in, static_cast<off_t>(src));
+                file_offset(out, static_cast<off_t>(dst));
+                return supported;
+            }
+
+            bool copy_file_to_socket(file_stream& from, const socket& to)
+            {
+                auto in = from.native_handle();
+                auto status = file_status(in);
+
+                if (!S_ISREG(status.st_mode))
+                {
+                    return false;
+                }
+
+                auto remaining = static_cast<size_t>(std::max<off_t>(status.st_size - file_offset(in), 0));
+                auto chunk = std::min(std::max<size_t>(remaining, 1), max_chunk_size);
+
+                while (true)
+                {
+                    auto n = sendfile(to.native_handle(), in, nullptr, chunk);
+
+                    if (n == -1)
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        {
+                            wait(to, select_mode::write);
+                            continue;
+                        }
+                        if (is_unsupported(errno))
+                        {
+                            return false;
+                        }
+
+                        throw std::system_error(errno, std::system_category(), "sendfile");
+                    }
+                    if (n == 0)
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            bool copy_socket(const socket& from, stream& to, int out, std::streamsize buffer_size)
+            {
+                pipe p;
+                auto chunk = static_cast<size_t>(buffer_size);
+
+                while (true)
+                {
+                    auto n = splice(from.native_handle(), nullptr, p.write_end(), nullptr, chunk, SPLICE_F_MOVE);
+
+                    if (n == -1)
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        {
+                            wait(from, select_mode::read);
+                            continue;
+                        }
+                        if (is_unsupported(errno))
+                        {
+                            return false;
+                        }
+
+                        throw std::system_error(errno, std::system_category(), "splice");
+                    }
+                    if (n == 0)
+                    {
+                        return true;
+                    }
+
+                    while (n > 0)
+                    {
+                        auto m = splice(p.read_end(), nullptr, out, nullptr, static_cast<size_t>(n), SPLICE_F_MOVE);
+
+                        if (m == -1)
+                        {
+                            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                            {
+                                wait_writable(out);
+                                continue;
+                            }
+                            if (!is_unsupported(errno))
+                            {
+                                throw std::system_error(errno, std::system_category(), "splice");
+                            }
+
+                            // The data already left the socket, hand what is left in the pipe over by hand.
+                            std::vector<uint8_t> rest(static_cast<size_t>(n));
+                            auto r = ::read(p.read_end(), rest.data(), rest.size());
+
+                            if (r == -1)
+                            {
+                                throw std::system_error(errno, std::system_category(), "read");
+                            }
+
+                            to.write(gsl::span<const uint8_t>(rest.data(), r));
+                            return false;
+                        }
+
+                        n -= m;
+                    }
+                }
+            }
+        }
+
+        bool kernel_copy::run(stream& from, stream& to, std::streamsize buffer_size)
+        {
+            if (!from.can_read() || !to.can_write())
+            {
+                return false;
+            }
+
+            auto file_from = dynamic_cast<file_stream*>(&from);
+            auto file_to = dynamic_cast<file_stream*>(&to);
+            auto network_from = dynamic_cast<network_stream*>(&from);
+            auto network_to = dynamic_cast<network_stream*>(&to);
+
+            // Appending files have no usable offset, those are left to plain writes.
+            if (file_to != nullptr && !file_to->can_seek())
+            {
+                return false;
+            }
+
+            if (file_from != nullptr && file_to != nullptr)
+            {
+                return copy_file_to_file(*file_from, *file_to);
+            }
+            if (file_from != nullptr && network_to != nullptr)
+            {
+                return copy_file_to_socket(*file_from, *network_to->socket());
+            }
+            if (network_from != nullptr && network_to != nullptr)
+            {
+                return copy_socket(*network_from->socket(), to, network_to->socket()->native_handle(), buffer_size);
+            }
+            if (network_from != nullptr && file_to != nullptr)
+            {
+                return copy_socket(*network_from->socket(), to, file_to->native_handle(), buffer_size);
+            }
+
+            return false;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifdef _WIN32
+#include <exa/detail/kernel_copy.hpp>
+
+namespace exa
+{
+    namespace detail
+    {
+        bool kernel_copy::run(stream&, stream&, std::streamsize)
+        {
+            return false;
+        }
+    }
+}
+
+#endif
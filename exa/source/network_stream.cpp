@@ -9,6 +9,21 @@ using namespace std::chrono_literals;
 
 namespace exa
 {
+    namespace
+    {
+        size_t total_size(gsl::span<const gsl::span<const uint8_t>> buffers)
+        {
+            size_t n = 0;
+
+            for (auto& b : buffers)
+            {
+                n += static_cast<size_t>(b.size());
+            }
+
+            return n;
+        }
+    }
+
     network_stream::network_stream(const std::shared_ptr<exa::socket>& socket, bool owns)
         : network_stream(socket, file_access::read_write, owns)
     {
@@ -275,6 +290,103 @@ namespace exa
         });
     }
 
+    std::streamsize network_stream::read(gsl::span<const gsl::span<uint8_t>> buffers)
+    {
+        if (!socket_->valid())
+        {
+            throw std::runtime_error("Invalid socket in network stream.");
+        }
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Read buffers are a nullptr.");
+        }
+        if (!readable_)
+        {
+            throw std::runtime_error("Reading isn't supported for this network stream.");
+        }
+
+        return static_cast<std::streamsize>(socket_->receive(buffers));
+    }
+
+    std::future<std::streamsize> network_stream::read_async(gsl::span<const gsl::span<uint8_t>> buffers)
+    {
+        if (!socket_->valid())
+        {
+            throw std::runtime_error("Invalid socket in network stream.");
+        }
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Read buffers are a nullptr.");
+        }
+        if (!readable_)
+        {
+            throw std::runtime_error("Reading isn't supported for this network stream.");
+        }
+
+        return detail::io_task::run<std::streamsize>([=] {
+            return socket_->poll(0us, select_mode::read)
+                       ? std::make_tuple(true, static_cast<std::streamsize>(socket_->receive(buffers)))
+                       : std::make_tuple(false, static_cast<std::streamsize>(0));
+        });
+    }
+
+    void network_stream::write(gsl::span<const gsl::span<const uint8_t>> buffers)
+    {
+        if (!socket_->valid())
+        {
+            throw std::runtime_error("Invalid socket in network stream.");
+        }
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Write buffers are a nullptr.");
+        }
+        if (!writable_)
+        {
+            throw std::runtime_error("Writing isn't supported for this network stream.");
+        }
+
+        auto n = socket_->send(buffers);
+
+        if (n != total_size(buffers))
+        {
+            throw std::runtime_error("Not all bytes were written to the network stream.");
+        }
+    }
+
+    std::future<void> network_stream::write_async(gsl::span<const gsl::span<const uint8_t>> buffers)
+    {
+        if (!socket_->valid())
+        {
+            throw std::runtime_error("Invalid socket in network stream.");
+        }
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Write buffers are a nullptr.");
+        }
+        if (!writable_)
+        {
+            throw std::runtime_error("Writing isn't supported for this network stream.");
+        }
+
+        return detail::io_task::run<void>([=] {
+            if (socket_->poll(0us, select_mode::write))
+            {
+                auto n = socket_->send(buffers);
+
+                if (n != total_size(buffers))
+                {
+                    throw std::runtime_error("Not all bytes were written to the network stream.");
+                }
+
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        });
+    }
+
     bool network_stream::data_available() const
     {
         return socket_->available() > 0;
@@ -0,0 +1,51 @@
+#include <exa/periodic_worker.hpp>
+#include <exa/concepts.hpp>
+
+namespace exa
+{
+    namespace detail
+    {
+        periodic_worker::~periodic_worker()
+        {
+            stop();
+        }
+
+        bool periodic_worker::running() const
+        {
+            return run_;
+        }
+
+        void periodic_worker::start(const std::chrono::milliseconds& interval, std::function<void()> work)
+        {
+            std::lock_guard<std::mutex> control(control_mutex_);
+
+            if (run_.exchange(true))
+            {
+                return;
+            }
+
+            thread_ = std::thread([this, interval, work = std::move(work)] {
+                std::unique_lock<std::mutex> l(wait_mutex_);
+
+                while (!wait_signal_.wait_for(l, interval, [this] { return !run_; }))
+                {
+                    l.unlock();
+                    work();
+                    l.lock();
+                }
+            });
+        }
+
+        void periodic_worker::stop()
+        {
+            std::lock_guard<std::mutex> control(control_mutex_);
+            lock(wait_mutex_, [this] { run_ = false; });
+            wait_signal_.notify_all();
+
+            if (thread_.joinable())
+            {
+                thread_.join();
+            }
+        }
+    }
+}
@@ -0,0 +1,335 @@
+#ifndef _WIN32
+#include <exa/poller.hpp>
+#include <exa/enum_flag.hpp>
+#include <exa/concepts.hpp>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace exa
+{
+    namespace
+    {
+        constexpr uint64_t notify_key = std::numeric_limits<uint64_t>::max();
+
+        uint32_t to_epoll_events(poll_events events)
+        {
+            uint32_t result = 0;
+
+            if (has_flag(events, poll_events::read))
+            {
+                result |= EPOLLIN | EPOLLRDHUP;
+            }
+            if (has_flag(events, poll_events::write))
+            {
+                result |= EPOLLOUT;
+            }
+            if (has_flag(events, poll_events::edge_triggered))
+            {
+                result |= EPOLLET;
+            }
+            if (has_flag(events, poll_events::one_shot))
+            {
+                result |= EPOLLONESHOT;
+            }
+
+            return result;
+        }
+
+        poll_events from_epoll_events(uint32_t events)
+        {
+            auto result = poll_events::none;
+
+            if ((events & EPOLLIN) != 0)
+            {
+                result = result | poll_events::read;
+            }
+            if ((events & EPOLLOUT) != 0)
+            {
+                result = result | poll_events::write;
+            }
+            if ((events & EPOLLERR) != 0)
+            {
+                result = result | poll_events::error;
+            }
+            if ((events & (EPOLLHUP | EPOLLRDHUP)) != 0)
+            {
+                result = result | poll_events::hang_up;
+            }
+
+            return result;
+        }
+    }
+
+    struct poller::poller_context
+    {
+        struct registration
+        {
+            std::shared_ptr<socket> socket;
+            poll_events events;
+            void* user_data;
+            uint32_t generation;
+        };
+
+        struct registrations : public std::unordered_map<int, registration>, public lockable<std::mutex>
+        {
+        };
+
+        int epoll = -1;
+        int notify = -1;
+        uint32_t generation = 0;
+        registrations sockets;
+        std::vector<epoll_event> ready;
+
+        static uint64_t key(int fd, uint32_t generation)
+        {
+            return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+        }
+
+        void control(int operation, int fd, poll_events events, uint32_t generation)
+        {
+            epoll_event e = {0};
+            e.events = to_epoll_events(events);
+            e.data.u64 = key(fd, generation);
+
+            if (epoll_ctl(epoll, operation, fd, &e) == -1)
+            {
+                throw std::system_error(errno, std::system_category(), "epoll_ctl");
+            }
+        }
+    };
+
+    poller::poller() : context_(std::make_unique<poller_context>())
+    {
+        context_->epoll = epoll_create1(EPOLL_CLOEXEC);
+
+        if (context_->epoll == -1)
+        {
+            throw std::system_error(errno, std::system_category(), "epoll_create1");
+        }
+
+        context_->notify = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (context_->notify == -1)
+        {
+            auto error = errno;
+            ::close(context_->epoll);
+            throw std::system_error(error, std::system_category(), "eventfd");
+        }
+
+        epoll_event e = {0};
+        e.events = EPOLLIN;
+        e.data.u64 = notify_key;
+
+        if (epoll_ctl(context_->epoll, EPOLL_CTL_ADD, context_->notify, &e) == -1)
+        {
+            auto error = errno;
+            ::close(context_->notify);
+            ::close(context_->epoll);
+            throw std::system_error(error, std::system_category(), "epoll_ctl");
+        }
+    }
+
+    poller::~poller()
+    {
+        ::close(context_->notify);
+        ::close(context_->epoll);
+    }
+
+    size_t poller::size() const
+    {
+        size_t n = 0;
+        lock(context_->sockets, [&] { n = context_->sockets.size(); });
+        return n;
+    }
+
+    bool poller::contains(const std::shared_ptr<socket>& s) const
+    {
+        if (s == nullptr || !s->valid())
+        {
+            return false;
+        }
+
+        bool found = false;
+        lock(context_->sockets, [&] { found = context_->sockets.count(s->native_handle()) > 0; });
+        return found;
+    }
+
+    void poller::add(const std::shared_ptr<socket>& s, poll_events events, void* user_data)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't add nullptr socket to poller.");
+        }
+
+        auto fd = s->native_handle();
+
+        lock(context_->sockets, [&] {
+            auto it = context_->sockets.find(fd);
+
+            if (it != std::end(context_->sockets))
+            {
+                if (it->second.socket == s)
+                {
+                    throw std::invalid_argument("Socket is already registered in poller.");
+                }
+
+                // The previous socket was closed without being removed and its descriptor got reused.
+                context_->sockets.erase(it);
+            }
+
+            auto generation = ++context_->generation;
+            context_->control(EPOLL_CTL_ADD, fd, events, generation);
+            context_->sockets.emplace(fd, poller_context::registration{s, events, user_data, generation});
+        });
+    }
+
+    void poller::modify(const std::shared_ptr<socket>& s, poll_events events)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't modify nullptr socket in poller.");
+        }
+
+        auto fd = s->native_handle();
+
+        lock(context_->sockets, [&] {
+            auto it = context_->sockets.find(fd);
+
+            if (it == std::end(context_->sockets))
+            {
+                throw std::invalid_argument("Socket isn't registered in poller.");
+            }
+
+            context_->control(EPOLL_CTL_MOD, fd, events, it->second.generation);
+            it->second.events = events;
+        });
+    }
+
+    void poller::modify(const std::shared_ptr<socket>& s, poll_events events, void* user_data)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't modify nullptr socket in poller.");
+        }
+
+        auto fd = s->native_handle();
+
+        lock(context_->sockets, [&] {
+            auto it = context_->sockets.find(fd);
+
+            if (it == std::end(context_->sockets))
+            {
+                throw std::invalid_argument("Socket isn't registered in poller.");
+            }
+
+            context_->control(EPOLL_CTL_MOD, fd, events, it->second.generation);
+            it->second.events = events;
+            it->second.user_data = user_data;
+        });
+    }
+
+    void poller::remove(const std::shared_ptr<socket>& s)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't remove nullptr socket from poller.");
+        }
+
+        lock(context_->sockets, [&] {
+            if (s->valid())
+            {
+                auto it = context_->sockets.find(s->native_handle());
+
+                if (it != std::end(context_->sockets) && it->second.socket == s)
+                {
+                    epoll_ctl(context_->epoll, EPOLL_CTL_DEL, it->first, nullptr);
+                    context_->sockets.erase(it);
+                }
+            }
+            else
+            {
+                // Closed sockets were already dropped by epoll, only the registration is left.
+                auto it = std::find_if(std::begin(context_->sockets), std::end(context_->sockets),
+                                       [&](auto&& r) { return r.second.socket == s; });
+
+                if (it != std::end(context_->sockets))
+                {
+                    context_->sockets.erase(it);
+                }
+            }
+        });
+    }
+
+    void poller::notify()
+    {
+        uint64_t value = 1;
+
+        if (::write(context_->notify, &value, sizeof(value)) == -1 && errno != EAGAIN)
+        {
+            throw std::system_error(errno, std::system_category(), "write");
+        }
+    }
+
+    size_t poller::wait(gsl::span<poll_event> events, const std::chrono::milliseconds& timeout)
+    {
+        if (events.empty())
+        {
+            throw std::invalid_argument("Poller needs room for at least one event.");
+        }
+
+        auto max_events = static_cast<size_t>(std::min<std::ptrdiff_t>(events.size(), std::numeric_limits<int>::max()));
+        context_->ready.resize(max_events);
+        auto ms = timeout.count() < 0 ? -1
+                                      : static_cast<int>(std::min<std::chrono::milliseconds::rep>(
+                                            timeout.count(), std::numeric_limits<int>::max()));
+        auto n = epoll_wait(context_->epoll, context_->ready.data(), static_cast<int>(max_events), ms);
+
+        if (n == -1)
+        {
+            if (errno == EINTR)
+            {
+                return 0;
+            }
+
+            throw std::system_error(errno, std::system_category(), "epoll_wait");
+        }
+
+        size_t count = 0;
+
+        lock(context_->sockets, [&] {
+            for (int i = 0; i < n; ++i)
+            {
+                auto& ready = context_->ready[i];
+
+                if (ready.data.u64 == notify_key)
+                {
+                    uint64_t value = 0;
+                    ::read(context_->notify, &value, sizeof(value));
+                    continue;
+                }
+
+                auto fd = static_cast<int>(ready.data.u64 & 0xffffffff);
+                auto it = context_->sockets.find(fd);
+
+                if (it == std::end(context_->sockets) || it->second.generation != (ready.data.u64 >> 32))
+                {
+                    continue;
+                }
+
+                auto& e = events[static_cast<std::ptrdiff_t>(count++)];
+                e.socket = it->second.socket;
+                e.events = from_epoll_events(ready.events);
+                e.user_data = it->second.user_data;
+            }
+        });
+
+        return count;
+    }
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifdef _WIN32
+#include <exa/poller.hpp>
+#include <exa/enum_flag.hpp>
+#include <exa/concepts.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    struct poller::poller_context
+    {
+        struct registration
+        {
+            std::shared_ptr<socket> socket;
+            poll_events events;
+            void* user_data;
+        };
+
+        struct registrations : public std::vector<registration>, public lockable<std::mutex>
+        {
+        };
+
+        std::shared_ptr<socket> notify;
+        registrations sockets;
+        std::vector<WSAPOLLFD> descriptors;
+
+        static SHORT to_poll_events(poll_events events)
+        {
+            SHORT result = 0;
+
+            if (has_flag(events, poll_events::read))
+            {
+                result |= POLLRDNORM;
+            }
+            if (has_flag(events, poll_events::write))
+            {
+                result |= POLLWRNORM;
+            }
+
+            return result;
+        }
+
+        std::vector<registration>::iterator find(const std::shared_ptr<socket>& s)
+        {
+            return std::find_if(std::begin(sockets), std::end(sockets), [&](auto&& r) { return r.socket == s; });
+        }
+    };
+
+    poller::poller() : context_(std::make_unique<poller_context>())
+    {
+        context_->notify =
+            std::make_shared<exa::socket>(address_family::inter_network, socket_type::datagram, protocol_type::udp);
+        context_->notify->bind(address::loopback, 0);
+        context_->notify->connect(context_->notify->local_endpoint());
+        context_->notify->blocking(false);
+    }
+
+    poller::~poller()
+    {
+    }
+
+    size_t poller::size() const
+    {
+        size_t n = 0;
+        lock(context_->sockets, [&] { n = context_->sockets.size(); });
+        return n;
+    }
+
+    bool poller::contains(const std::shared_ptr<socket>& s) const
+    {
+        bool found = false;
+        lock(context_->sockets, [&] { found = context_->find(s) != std::end(context_->sockets); });
+        return found;
+    }
+
+    void poller::add(const std::shared_ptr<socket>& s, poll_events events, void* user_data)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't add nullptr socket to poller.");
+        }
+        if (has_flag(events, poll_events::edge_triggered))
+        {
+            throw std::invalid_argument("Edge triggered polling isn't supported on Windows.");
+        }
+
+        lock(context_->sockets, [&] {
+            if (context_->find(s) != std::end(context_->sockets))
+            {
+                throw std::invalid_argument("Socket is already registered in poller.");
+            }
+
+            context_->sockets.push_back(poller_context::registration{s, events, user_data});
+        });
+    }
+
+    void poller::modify(const std::shared_ptr<socket>& s, poll_events events)
+    {
+        lock(context_->sockets, [&] {
+            auto it = context_->find(s);
+
+            if (it == std::end(context_->sockets))
+            {
+                throw std::invalid_argument("Socket isn't registered in poller.");
+            }
+
+            it->events = events;
+        });
+    }
+
+    void poller::modify(const std::shared_ptr<socket>& s, poll_events events, void* user_data)
+    {
+        lock(context_->sockets, [&] {
+            auto it = context_->find(s);
+
+            if (it == std::end(context_->sockets))
+            {
+                throw std::invalid_argument("Socket isn't registered in poller.");
+            }
+
+            it->events = events;
+            it->user_data = user_data;
+        });
+    }
+
+    void poller::remove(const std::shared_ptr<socket>& s)
+    {
+        lock(context_->sockets, [&] {
+            auto it = context_->find(s);
+
+            if (it != std::end(context_->sockets))
+            {
+                context_->sockets.erase(it);
+            }
+        });
+    }
+
+    void poller::notify()
+    {
+        uint8_t value = 1;
+        context_->notify->send(gsl::span<const uint8_t>(&value, 1));
+    }
+
+    size_t poller::wait(gsl::span<poll_event> events, const std::chrono::milliseconds& timeout)
+    {
+        if (events.empty())
+        {
+            throw std::invalid_argument("Poller needs room for at least one event.");
+        }
+
+        std::vector<poller_context::registration> snapshot;
+
+        lock(context_->sockets, [&] {
+            snapshot.assign(std::begin(context_->sockets), std::end(context_->sockets));
+        });
+
+        auto& descriptors = context_->descriptors;
+        descriptors.resize(snapshot.size() + 1);
+        descriptors[0] = WSAPOLLFD{context_->notify->native_handle(), POLLRDNORM, 0};
+
+        for (size_t i = 0; i < snapshot.size(); ++i)
+        {
+            descriptors[i + 1] =
+                WSAPOLLFD{snapshot[i].socket->native_handle(), poller_context::to_poll_events(snapshot[i].events), 0};
+        }
+
+        auto ms = timeout.count() < 0 ? -1
+                                      : static_cast<INT>(std::min<std::chrono::milliseconds::rep>(
+                                            timeout.count(), std::numeric_limits<INT>::max()));
+        auto n = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), ms);
+
+        if (n == SOCKET_ERROR)
+        {
+            throw std::system_error(WSAGetLastError(), std::system_category(), "WSAPoll");
+        }
+
+        if (descriptors[0].revents != 0)
+        {
+            std::array<uint8_t, 64> drain;
+
+            while (context_->notify->available() > 0)
+            {
+                context_->notify->receive(drain);
+            }
+        }
+
+        size_t count = 0;
+
+        for (size_t i = 1; i < descriptors.size() && count < static_cast<size_t>(events.size()); ++i)
+        {
+            auto revents = descriptors[i].revents;
+
+            if (revents == 0)
+            {
+                continue;
+            }
+
+            auto& r = snapshot[i - 1];
+            auto& e = events[static_cast<std::ptrdiff_t>(count++)];
+            e.socket = r.socket;
+            e.events = poll_events::none;
+            e.user_data = r.user_data;
+
+            if ((revents & POLLRDNORM) != 0)
+            {
+                e.events = e.events | poll_events::read;
+            }
+            if ((revents & POLLWRNORM) != 0)
+            {
+                e.events = e.events | poll_events::write;
+            }
+            if ((revents & (POLLERR | POLLNVAL)) != 0)
+            {
+                e.events = e.events | poll_events::error;
+            }
+            if ((revents & POLLHUP) != 0)
+            {
+                e.events = e.events | poll_events::hang_up;
+            }
+
+            if (has_flag(r.events, poll_events::one_shot))
+            {
+                modify(r.socket, poll_events::none);
+            }
+        }
+
+        return count;
+    }
+}
+
+#endif
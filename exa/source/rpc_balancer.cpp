@@ -0,0 +1,287 @@
+#include <exa/rpc_balancer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    namespace
+    {
+        // Longest an expired ejection waits for the background reconnect.
+        constexpr auto revive_interval = 100ms;
+    }
+
+    struct rpc_balancer::backend : public lockable<std::mutex>
+    {
+        endpoint ep;
+        std::shared_ptr<rpc_client> client;
+        size_t outstanding = 0;
+        std::chrono::microseconds latency{0};
+        bool measured = false;
+        uint64_t completed = 0;
+        uint64_t ejections = 0;
+        bool ejected = false;
+        std::chrono::steady_clock::time_point ejected_until;
+    };
+
+    rpc_balancer::rpc_balancer(const std::vector<endpoint>& endpoints, const rpc_balancer_options& options)
+        : options_(options)
+    {
+        if (endpoints.empty())
+        {
+            throw std::invalid_argument("RPC balancer needs at least one endpoint.");
+        }
+        if (options.latency_weight <= 0 || options.latency_weight > 1)
+        {
+            throw std::out_of_range("Latency weight needs to be within (0, 1].");
+        }
+        if (options.ejection_time.count() <= 0)
+        {
+            throw std::out_of_range("Ejection time must be greater than 0.");
+        }
+
+        for (auto& ep : endpoints)
+        {
+            auto b = std::make_shared<backend>();
+            b->ep = ep;
+            backends_.push_back(b);
+            revive(*b);
+        }
+
+        worker_.start(std::min<std::chrono::milliseconds>(options.ejection_time, revive_interval),
+                      [this] { revive_expired(); });
+    }
+
+    rpc_balancer::~rpc_balancer()
+    {
+        worker_.stop();
+
+        for (auto& b : backends_)
+        {
+            std::shared_ptr<rpc_client> client;
+            lock(*b, [&] { client.swap(b->client); });
+            // Closing fails outstanding calls, their callbacks lock the backend.
+            client.reset();
+        }
+    }
+
+    const rpc_balancer_options& rpc_balancer::options() const
+    {
+        return options_;
+    }
+
+    size_t rpc_balancer::size() const
+    {
+        return backends_.size();
+    }
+
+    size_t rpc_balancer::available() const
+    {
+        size_t n = 0;
+
+        for (auto& b : backends_)
+        {
+            lock(*b, [&] { n += b->ejected ? 0 : 1; });
+        }
+
+        return n;
+    }
+
+    std::vector<rpc_backend_status> rpc_balancer::status() const
+    {
+        std::vector<rpc_backend_status> result;
+
+        for (auto& b : backends_)
+        {
+            lock(*b, [&] {
+                rpc_backend_status s;
+                s.ep = b->ep;
+                s.outstanding = b->outstanding;
+                s.latency = b->latency;
+                s.completed = b->completed;
+                s.ejections = b->ejections;
+                s.ejected = b->ejected;
+                result.push_back(s);
+            });
+        }
+
+        return result;
+    }
+
+    std::future<std::vector<uint8_t>> rpc_balancer::call(gsl::span<const uint8_t> request)
+    {
+        for (size_t attempt = 0; attempt < backends_.size(); ++attempt)
+        {
+            auto b = select();
+
+            if (b == nullptr)
+            {
+                break;
+            }
+
+            std::shared_ptr<rpc_client> client;
+            lock(*b, [&] {
+                client = b->client;
+                b->outstanding += 1;
+            });
+
+            auto p = std::make_shared<std::promise<std::vector<uint8_t>>>();
+            auto start = std::chrono::steady_clock::now();
+            auto options = options_;
+
+            // Holding the client in its own callback would keep it alive on its reader thread.
+            auto on_complete = [b, p, start, options, raw = client.get()](auto&& response, auto error) {
+                auto latency =
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+                lock(*b, [&] {
+                    b->outstanding -= 1;
+
+                    if (error != nullptr && raw->closed())
+                    {
+                        // Lost the connection, errors sent by the server don't count against the backend.
+                        if (b->client.get() == raw && !b->ejected)
+                        {
+                            eject(*b, options);
+                        }
+
+                        return;
+                    }
+
+                    auto w = options.latency_weight;
+                    b->latency = b->measured ? std::chrono::microseconds(static_cast<int64_t>(
+                                                   w * latency.count() + (1 - w) * b->latency.count()))
+                                             : latency;
+                    b->measured = true;
+                    b->completed += 1;
+
+                    if (options.max_latency.count() > 0 && b->latency > options.max_latency && !b->ejected)
+                    {
+                        eject(*b, options);
+                    }
+                });
+
+                if (error != nullptr)
+                {
+                    p->set_exception(error);
+                }
+                else
+                {
+                    p->set_value(std::move(response));
+                }
+            };
+
+            try
+            {
+                client->call(request, on_complete);
+                return p->get_future();
+            }
+            catch (const std::runtime_error&)
+            {
+                // The connection was closed since the backend got selected, try another one.
+                lock(*b, [&] {
+                    b->outstanding -= 1;
+
+                    if (b->client == client && !b->ejected)
+                    {
+                        eject(*b, options_);
+                    }
+                });
+            }
+        }
+
+        throw std::runtime_error("No RPC backend is available.");
+    }
+
+    std::shared_ptr<rpc_balancer::backend> rpc_balancer::select()
+    {
+        std::shared_ptr<backend> best;
+        std::pair<uint64_t, uint64_t> best_key;
+        auto first = next_++;
+
+        // Starting at a different backend every time spreads calls over backends that are equally good.
+        for (size_t i = 0; i < backends_.size(); ++i)
+        {
+            auto& b = backends_[(first + i) % backends_.size()];
+
+            lock(*b, [&] {
+                if (!b->ejected && b->client != nullptr && b->client->closed())
+                {
+                    eject(*b, options_);
+                }
+                if (b->ejected)
+                {
+                    return;
+                }
+
+                auto outstanding = static_cast<uint64_t>(b->outstanding);
+                auto latency = static_cast<uint64_t>(b->latency.count());
+                auto key = options_.policy == rpc_balance_policy::least_outstanding
+                               ? std::make_pair(outstanding, latency)
+                               : std::make_pair(latency, outstanding);
+
+                if (best == nullptr || key < best_key)
+                {
+                    best = b;
+                    best_key = key;
+                }
+            });
+        }
+
+        return best;
+    }
+
+    void rpc_balancer::revive_expired()
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        for (auto& b : backends_)
+        {
+            auto expired = false;
+            lock(*b, [&] { expired = b->ejected && now >= b->ejected_until; });
+
+            if (expired)
+            {
+                revive(*b);
+            }
+        }
+    }
+
+    void rpc_balancer::revive(backend& b)
+    {
+        std::shared_ptr<rpc_client> client;
+        lock(b, [&] { client = b.client; });
+
+        // Backends ejected for being slow still have a working connection.
+        if (client == nullptr || client->closed())
+        {
+            try
+            {
+                auto c = std::make_shared<tcp_client>(b.ep.family());
+                c->connect(b.ep);
+                client = std::make_shared<rpc_client>(c, options_.rpc);
+            }
+            catch (const std::runtime_error&)
+            {
+                lock(b, [&] { eject(b, options_); });
+                return;
+            }
+        }
+
+        lock(b, [&] {
+            client.swap(b.client);
+            b.ejected = false;
+            b.measured = false;
+            b.latency = std::chrono::microseconds(0);
+        });
+    }
+
+    void rpc_balancer::eject(backend& b, const rpc_balancer_options& options)
+    {
+        b.ejected = true;
+        b.ejected_until = std::chrono::steady_clock::now() + options.ejection_time;
+        b.ejections += 1;
+    }
+}
@@ -0,0 +1,225 @@
+#include <exa/rpc_client.hpp>
+
+#include <stdexcept>
+
+namespace exa
+{
+    rpc_client::rpc_client(const std::shared_ptr<tcp_client>& client, const rpc_options& options)
+        : client_(client), options_(options), codec_(options.max_frame_size)
+    {
+        if (client == nullptr)
+        {
+            throw std::invalid_argument("TCP client for RPC client is nullptr.");
+        }
+        if (!client->connected())
+        {
+            throw std::invalid_argument("TCP client for RPC client isn't connected.");
+        }
+        if (options.max_outstanding == 0)
+        {
+            throw std::out_of_range("RPC client needs room for at least one outstanding request.");
+        }
+
+        stream_ = client_->stream();
+        reader_ = std::thread([this] { read_loop(); });
+        writer_ = std::thread([this] { write_loop(); });
+    }
+
+    rpc_client::~rpc_client()
+    {
+        close();
+    }
+
+    bool rpc_client::closed() const
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        return closed_;
+    }
+
+    size_t rpc_client::outstanding() const
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        return pending_.size();
+    }
+
+    const std::shared_ptr<tcp_client>& rpc_client::client() const
+    {
+        return client_;
+    }
+
+    std::future<std::vector<uint8_t>> rpc_client::call(gsl::span<const uint8_t> request)
+    {
+        auto p = std::make_shared<std::promise<std::vector<uint8_t>>>();
+        auto f = p->get_future();
+
+        call(request, [p](auto&& response, auto error) {
+            if (error != nullptr)
+            {
+                p->set_exception(error);
+            }
+            else
+            {
+                p->set_value(std::move(response));
+            }
+        });
+
+        return f;
+    }
+
+    void rpc_client::call(gsl::span<const uint8_t> request, const rpc_callback& callback)
+    {
+        if (!callback)
+        {
+            throw std::invalid_argument("RPC callback is empty.");
+        }
+
+        std::unique_lock<std::mutex> l(mutex_);
+        slots_.wait(l, [this] { return closed_ || pending_.size() < options_.max_outstanding; });
+
+        if (closed_)
+        {
+            throw std::runtime_error("RPC client is closed.");
+        }
+
+        auto id = next_id_++;
+        pending_.emplace(id, callback);
+        rpc_codec::encode(queued_, rpc_frame_kind::request, id, request);
+        l.unlock();
+
+        queued_signal_.notify_one();
+    }
+
+    void rpc_client::close()
+    {
+        fail("RPC client is closed.");
+
+        if (client_->socket()->valid())
+        {
+            try
+            {
+                // Wakes up the reader blocked in receive.
+                client_->socket()->shutdown(socket_shutdown::both);
+            }
+            catch (const std::system_error&)
+            {
+                // The peer might have reset the connection already.
+            }
+        }
+
+        if (reader_.joinable())
+        {
+            reader_.join();
+        }
+        if (writer_.joinable())
+        {
+            writer_.join();
+        }
+    }
+
+    void rpc_client::read_loop()
+    {
+        std::vector<uint8_t> buffer(64 * 1024);
+
+        try
+        {
+            while (true)
+            {
+                auto n = stream_->read(buffer);
+
+                if (n <= 0)
+                {
+                    fail("RPC connection was closed by the peer.");
+                    return;
+                }
+
+                for (auto& f : codec_.decode(gsl::span<const uint8_t>(buffer.data(), n)))
+                {
+                    rpc_callback callback;
+
+                    {
+                        std::lock_guard<std::mutex> l(mutex_);
+                        auto it = pending_.find(f.id);
+
+                        if (it != std::end(pending_))
+                        {
+                            callback = std::move(it->second);
+                            pending_.erase(it);
+                        }
+                    }
+
+                    if (!callback)
+                    {
+                        continue;
+                    }
+
+                    slots_.notify_one();
+
+                    if (f.kind == rpc_frame_kind::error)
+                    {
+                        std::string message(std::begin(f.payload), std::end(f.payload));
+                        callback(std::vector<uint8_t>(), std::make_exception_ptr(std::runtime_error(message)));
+                    }
+                    else
+                    {
+                        callback(std::move(f.payload), nullptr);
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            fail(e.what());
+        }
+    }
+
+    void rpc_client::write_loop()
+    {
+        std::vector<uint8_t> batch;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> l(mutex_);
+                queued_signal_.wait(l, [this] { return closed_ || !queued_.empty(); });
+
+                if (closed_)
+                {
+                    return;
+                }
+
+                batch.clear();
+                batch.swap(queued_);
+            }
+
+            try
+            {
+                stream_->write(batch);
+            }
+            catch (const std::exception& e)
+            {
+                fail(e.what());
+                return;
+            }
+        }
+    }
+
+    void rpc_client::fail(const std::string& message)
+    {
+        std::unordered_map<uint64_t, rpc_callback> failed;
+
+        {
+            std::lock_guard<std::mutex> l(mutex_);
+            closed_ = true;
+            failed.swap(pending_);
+            queued_.clear();
+        }
+
+        slots_.notify_all();
+        queued_signal_.notify_all();
+
+        for (auto& [id, callback] : failed)
+        {
+            callback(std::vector<uint8_t>(), std::make_exception_ptr(std::runtime_error(message)));
+        }
+    }
+}
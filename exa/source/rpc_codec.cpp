@@ -0,0 +1,98 @@
+#include <exa/rpc_codec.hpp>
+
+#include <limits>
+#include <stdexcept>
+
+namespace exa
+{
+    namespace
+    {
+        uint64_t read_big_endian(const uint8_t* p, size_t size)
+        {
+            uint64_t value = 0;
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                value = (value << 8) | p[i];
+            }
+
+            return value;
+        }
+
+        void write_big_endian(std::vector<uint8_t>& out, uint64_t value, size_t size)
+        {
+            for (size_t i = size; i > 0; --i)
+            {
+                out.push_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+            }
+        }
+    }
+
+    rpc_codec::rpc_codec(size_t max_frame_size) : max_frame_size_(max_frame_size)
+    {
+        if (max_frame_size == 0 || max_frame_size > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::out_of_range("Maximum RPC frame size is out of range.");
+        }
+    }
+
+    void rpc_codec::encode(std::vector<uint8_t>& out, rpc_frame_kind kind, uint64_t id,
+                           gsl::span<const uint8_t> payload)
+    {
+        if (static_cast<uint64_t>(payload.size()) > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::out_of_range("RPC payload is too large to be framed.");
+        }
+
+        out.reserve(out.size() + header_size + static_cast<size_t>(payload.size()));
+        write_big_endian(out, static_cast<uint64_t>(payload.size()), 4);
+        write_big_endian(out, id, 8);
+        out.push_back(static_cast<uint8_t>(kind));
+        out.insert(std::end(out), std::begin(payload), std::end(payload));
+    }
+
+    std::vector<rpc_frame> rpc_codec::decode(gsl::span<const uint8_t> data)
+    {
+        pending_.insert(std::end(pending_), std::begin(data), std::end(data));
+
+        std::vector<rpc_frame> frames;
+        size_t offset = 0;
+
+        while (pending_.size() - offset >= header_size)
+        {
+            auto p = pending_.data() + offset;
+            auto size = static_cast<size_t>(read_big_endian(p, 4));
+
+            if (size > max_frame_size_)
+            {
+                throw std::runtime_error("RPC frame exceeds the maximum frame size.");
+            }
+            if (pending_.size() - offset < header_size + size)
+            {
+                break;
+            }
+
+            rpc_frame f;
+            f.id = read_big_endian(p + 4, 8);
+            f.kind = static_cast<rpc_frame_kind>(p[12]);
+            f.payload.assign(p + header_size, p + header_size + size);
+
+            if (f.kind != rpc_frame_kind::request && f.kind != rpc_frame_kind::response &&
+                f.kind != rpc_frame_kind::error)
+            {
+                throw std::runtime_error("Unknown RPC frame kind.");
+            }
+
+            frames.push_back(std::move(f));
+            offset += header_size + size;
+        }
+
+        pending_.erase(std::begin(pending_), std::begin(pending_) + static_cast<std::ptrdiff_t>(offset));
+        return frames;
+    }
+
+    size_t rpc_codec::buffered() const
+    {
+        return pending_.size();
+    }
+}
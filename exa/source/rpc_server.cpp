@@ -0,0 +1,184 @@
+#include <exa/rpc_server.hpp>
+
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace exa
+{
+    struct rpc_responder::batch
+    {
+        std::mutex mutex;
+        std::vector<uint8_t> output;
+        bool open = true;
+    };
+
+    rpc_responder::rpc_responder(const std::shared_ptr<tcp_connection>& c, const std::shared_ptr<batch>& b,
+                                 uint64_t id)
+        : connection_(c), batch_(b), id_(id)
+    {
+    }
+
+    void rpc_responder::reply(gsl::span<const uint8_t> response) const
+    {
+        send(rpc_frame_kind::response, response);
+    }
+
+    void rpc_responder::fail(const std::string& message) const
+    {
+        send(rpc_frame_kind::error,
+             gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(message.data()),
+                                      static_cast<std::ptrdiff_t>(message.size())));
+    }
+
+    void rpc_responder::send(rpc_frame_kind kind, gsl::span<const uint8_t> payload) const
+    {
+        auto batched = false;
+
+        lock(batch_->mutex, [&] {
+            if (batch_->open)
+            {
+                rpc_codec::encode(batch_->output, kind, id_, payload);
+                batched = true;
+            }
+        });
+
+        if (batched)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> frame;
+        rpc_codec::encode(frame, kind, id_, payload);
+
+        if (auto c = connection_.lock())
+        {
+            try
+            {
+                c->send(frame);
+            }
+            catch (const std::runtime_error&)
+            {
+                // The connection was closed, nobody is waiting for the response anymore.
+            }
+        }
+    }
+
+    rpc_server::rpc_server(const endpoint& ep, const rpc_handler& handler, const rpc_options& options,
+                           const tcp_server_options& server_options)
+        : handler_(handler), options_(options)
+    {
+        if (!handler)
+        {
+            throw std::invalid_argument("RPC server needs a handler.");
+        }
+
+        if (options.max_frame_size == 0 || options.max_frame_size > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::out_of_range("Maximum RPC frame size is out of range.");
+        }
+
+        tcp_server_handlers handlers;
+        handlers.connected = [this](auto&& c) { c->user_data = std::make_shared<rpc_codec>(options_.max_frame_size); };
+        handlers.received = [this](auto&& c, auto data) { on_received(c, data); };
+        handlers.disconnected = [](auto&& c, auto&&) { c->user_data.reset(); };
+
+        server_ = std::make_unique<tcp_server>(ep, handlers, server_options);
+    }
+
+    rpc_server::~rpc_server()
+    {
+        stop();
+    }
+
+    bool rpc_server::active() const
+    {
+        return server_->active();
+    }
+
+    size_t rpc_server::connections() const
+    {
+        return server_->connections();
+    }
+
+    endpoint rpc_server::local_endpoint() const
+    {
+        return server_->local_endpoint();
+    }
+
+    void rpc_server::start()
+    {
+        server_->start();
+    }
+
+    void rpc_server::stop()
+    {
+        server_->stop();
+    }
+
+    void rpc_server::on_received(const std::shared_ptr<tcp_connection>& c, gsl::span<const uint8_t> data)
+    {
+        auto codec = std::static_pointer_cast<rpc_codec>(c->user_data);
+
+        if (codec == nullptr)
+        {
+            // Setting up the connection failed.
+            c->close();
+            return;
+        }
+
+        std::vector<rpc_frame> frames;
+
+        try
+        {
+            frames = codec->decode(data);
+        }
+        catch (const std::runtime_error&)
+        {
+            // Framing can't recover from a malformed frame.
+            c->close();
+            return;
+        }
+
+        auto b = std::make_shared<rpc_responder::batch>();
+
+        for (auto& f : frames)
+        {
+            if (f.kind != rpc_frame_kind::request)
+            {
+                c->close();
+                return;
+            }
+
+            rpc_responder respond(c, b, f.id);
+
+            try
+            {
+                handler_(f.payload, respond);
+            }
+            catch (const std::exception& e)
+            {
+                respond.fail(e.what());
+            }
+        }
+
+        std::vector<uint8_t> output;
+
+        lock(b->mutex, [&] {
+            b->open = false;
+            output.swap(b->output);
+        });
+
+        if (!output.empty() && !c->closed())
+        {
+            try
+            {
+                c->send(output);
+            }
+            catch (const std::runtime_error&)
+            {
+                // A handler closed the connection.
+            }
+        }
+    }
+}
@@ -2,17 +2,327 @@
 #include <exa/enum_flag.hpp>
 #include <exa/task.hpp>
 #include <exa/detail/io_task.hpp>
+#include <exa/concepts.hpp>
 
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <linux/errqueue.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#endif
+
+#if defined(__linux__) && !defined(IP_LOCAL_PORT_RANGE)
+// Available since Linux 6.3, older C libraries don't define it yet.
+#define IP_LOCAL_PORT_RANGE 51
+#endif
 
 using namespace exa::detail;
 using namespace std::chrono_literals;
 
 namespace exa
 {
+    namespace
+    {
+        short to_poll_events(select_mode mode)
+        {
+            switch (mode)
+            {
+                case select_mode::error:
+#ifdef _WIN32
+                    return 0;
+#else
+                    return POLLPRI;
+#endif
+                case select_mode::read:
+                    return POLLIN;
+                case select_mode::write:
+                    return POLLOUT;
+                default:
+                    return 0;
+            }
+        }
+
+        bool is_poll_ready(select_mode mode, short revents)
+        {
+            switch (mode)
+            {
+                case select_mode::error:
+                    return (revents & (POLLPRI | POLLERR)) != 0;
+                case select_mode::read:
+                    return (revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+                case select_mode::write:
+                    return (revents & (POLLOUT | POLLHUP | POLLERR)) != 0;
+                default:
+                    return false;
+            }
+        }
+
+#ifdef _WIN32
+        using io_buffer = WSABUF;
+#else
+        using io_buffer = iovec;
+#endif
+
+        template <class T>
+        class io_buffers
+        {
+        public:
+            explicit io_buffers(gsl::span<const gsl::span<T>> buffers) : size_(static_cast<size_t>(buffers.size()))
+            {
+                if (size_ > stack_.size())
+                {
+                    heap_.resize(size_);
+                }
+
+                auto p = data();
+
+                for (size_t i = 0; i < size_; ++i)
+                {
+                    auto& b = buffers[static_cast<std::ptrdiff_t>(i)];
+#ifdef _WIN32
+                    p[i].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(b.data()));
+                    p[i].len = static_cast<ULONG>(b.size());
+#else
+                    p[i].iov_base = const_cast<uint8_t*>(b.data());
+                    p[i].iov_len = static_cast<size_t>(b.size());
+#endif
+                }
+            }
+
+            io_buffer* data()
+            {
+                return heap_.empty() ? stack_.data() : heap_.data();
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+        private:
+            std::array<io_buffer, 16> stack_;
+            std::vector<io_buffer> heap_;
+            size_t size_;
+        };
+
+        constexpr size_t max_batch_size = 64;
+
+#ifdef TCP_INFO
+        // Layout of the kernel's struct tcp_info, the libc one stops at tcpi_total_retrans.
+        struct kernel_tcp_info
+        {
+            uint8_t state;
+            uint8_t ca_state;
+            uint8_t retransmits;
+            uint8_t probes;
+            uint8_t backoff;
+            uint8_t options;
+            uint8_t window_scales;
+            uint8_t flags;
+            uint32_t rto;
+            uint32_t ato;
+            uint32_t snd_mss;
+            uint32_t rcv_mss;
+            uint32_t unacked;
+            uint32_t sacked;
+            uint32_t lost;
+            uint32_t retrans;
+            uint32_t fackets;
+            uint32_t last_data_sent;
+            uint32_t last_ack_sent;
+            uint32_t last_data_recv;
+            uint32_t last_ack_recv;
+            uint32_t pmtu;
+            uint32_t rcv_ssthresh;
+            uint32_t rtt;
+            uint32_t rttvar;
+            uint32_t snd_ssthresh;
+            uint32_t snd_cwnd;
+            uint32_t advmss;
+            uint32_t reordering;
+            uint32_t rcv_rtt;
+            uint32_t rcv_space;
+            uint32_t total_retrans;
+            uint64_t pacing_rate;
+            uint64_t max_pacing_rate;
+            uint64_t bytes_acked;
+            uint64_t bytes_received;
+            uint32_t segs_out;
+            uint32_t segs_in;
+            uint32_t notsent_bytes;
+            uint32_t min_rtt;
+            uint32_t data_segs_in;
+            uint32_t data_segs_out;
+            uint64_t delivery_rate;
+            uint64_t busy_time;
+            uint64_t rwnd_limited;
+            uint64_t sndbuf_limited;
+            uint32_t delivered;
+            uint32_t delivered_ce;
+            uint64_t bytes_sent;
+            uint64_t bytes_retrans;
+        };
+#endif
+        constexpr auto send_timestamp_timeout = 1s;
+        // Limit of descriptors the kernel accepts in a single SCM_RIGHTS message.
+        constexpr size_t max_descriptors = 253;
+
+#ifdef SO_TIMESTAMPING
+        // Send timestamps are requested per message, so only sends which wait for them fill the error queue.
+        constexpr int timestamping_flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+                                           SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                                           SOF_TIMESTAMPING_OPT_TSONLY;
+        // Available since Linux 6.2, keys TCP reports by bytes written instead of bytes acknowledged. It's part of
+        // an enum, so older headers can't be detected by the preprocessor.
+        constexpr int timestamping_opt_id_tcp = 1 << 16;
+
+        struct stream_position
+        {
+            uint32_t written = 0;
+            uint32_t acknowledged = 0;
+        };
+
+        // Byte counts of a TCP socket from a fixed origin, the same one the kernel uses for timestamp keys.
+        // An acknowledgement arriving between the reads would skew the sum, so they're repeated until it's stable.
+        stream_position read_stream_position(int s)
+        {
+            auto acknowledged = [s] {
+                kernel_tcp_info info = {0};
+                socklen_t length = sizeof(info);
+
+                if (getsockopt(s, IPPROTO_TCP, TCP_INFO, &info, &length) != 0)
+                {
+                    throw std::system_error(errno, std::system_category(), "getsockopt");
+                }
+
+                return static_cast<uint32_t>(info.bytes_acked);
+            };
+
+            while (true)
+            {
+                auto before = acknowledged();
+                int queued = 0;
+
+                if (ioctl(s, SIOCOUTQ, &queued) != 0)
+                {
+                    throw std::system_error(errno, std::system_category(), "ioctl");
+                }
+                if (acknowledged() == before)
+                {
+                    return stream_position{before + static_cast<uint32_t>(queued), before};
+                }
+            }
+        }
+
+        bool read_timestamp(cmsghdr* cmsg, socket_timestamp& timestamp)
+        {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SO_TIMESTAMPING)
+            {
+                return false;
+            }
+
+            scm_timestamping t;
+            memcpy(&t, CMSG_DATA(cmsg), sizeof(t));
+            // The kernel leaves sources it didn't stamp zeroed.
+            auto to_time = [](const timespec& ts) -> std::optional<std::chrono::nanoseconds> {
+                if (ts.tv_sec == 0 && ts.tv_nsec == 0)
+                {
+                    return std::nullopt;
+                }
+
+                return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+            };
+
+            timestamp.software = to_time(t.ts[0]);
+            timestamp.hardware = to_time(t.ts[2]);
+            return true;
+        }
+
+        ssize_t receive_timestamped(int s, gsl::span<uint8_t> buffer, sockaddr_storage* name, socklen_t& name_length,
+                                    socket_timestamp& timestamp, int flags)
+        {
+            iovec b = {buffer.data(), static_cast<size_t>(buffer.size())};
+            std::array<char, CMSG_SPACE(sizeof(scm_timestamping)) * 2> control;
+            msghdr message = {0};
+            message.msg_name = name;
+            message.msg_namelen = name == nullptr ? 0 : sizeof(sockaddr_storage);
+            message.msg_iov = &b;
+            message.msg_iovlen = 1;
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+
+            auto n = recvmsg(s, &message, flags);
+            name_length = message.msg_namelen;
+
+            if (n != -1)
+            {
+                for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+                {
+                    read_timestamp(cmsg, timestamp);
+                }
+            }
+
+            return n;
+        }
+#endif
+
+        int to_poll_timeout(const std::chrono::microseconds& us)
+        {
+            if (us.count() < 0)
+            {
+                return -1;
+            }
+
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(us + 999us).count();
+            return static_cast<int>(std::min<decltype(ms)>(ms, std::numeric_limits<int>::max()));
+        }
+    }
+
     bool socket::ipv4_supported_ = socket::protocol_supported(address_family::inter_network);
     bool socket::ipv6_supported_ = socket::protocol_supported(address_family::inter_network_v6);
 
+    struct socket::error_queue_context : public lockable<std::mutex>
+    {
+        bool zero_copy = false;
+        uint32_t next_zero_copy_id = 0;
+        std::unordered_set<uint32_t> pending_zero_copy;
+        bool timestamping = false;
+        // Timestamped sends wait for their report one at a time, reports carry the key of their send.
+        std::mutex timestamped_send;
+        bool timestamp_keys = false;
+        // Stream keys are byte positions relative to this base, datagram keys count timestamped sends.
+        uint32_t timestamp_base = 0;
+        uint32_t next_timestamp_key = 0;
+        std::optional<uint32_t> pending_timestamp;
+        std::optional<socket_timestamp> reported_timestamp;
+    };
+
+    port_range port_range::shard(size_t index, size_t count) const
+    {
+        if (low == 0 || high < low)
+        {
+            throw std::invalid_argument("Port range to shard is empty.");
+        }
+
+        auto size = static_cast<size_t>(high - low) + 1;
+
+        if (count == 0 || count > size || index >= count)
+        {
+            throw std::out_of_range("Port range can't be split into the given shard.");
+        }
+
+        // The last shard takes the remainder.
+        auto share = size / count;
+        auto first = static_cast<uint16_t>(low + index * share);
+        auto last = index + 1 == count ? high : static_cast<uint16_t>(first + share - 1);
+        return port_range{first, last};
+    }
+
     socket::socket(socket_type type, protocol_type protocol)
         : socket(ipv6_supported() ? address_family::inter_network_v6 : address_family::inter_network, type, protocol)
     {
@@ -38,6 +348,20 @@ namespace exa
 #endif
     }
 
+    socket::socket(address_family family, socket_type type, protocol_type protocol, const socket_tuning& tuning)
+        : socket(family, type, protocol)
+    {
+        try
+        {
+            apply(tuning);
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+    }
+
     socket::socket(native_handle_type s, address_family family, protocol_type protocol)
     {
         socket_ = s;
@@ -47,11 +371,52 @@ namespace exa
         type_ = static_cast<socket_type>(get_socket_option<int>(SOL_SOCKET, SO_TYPE));
     }
 
+    socket::socket(native_handle_type s, address_family family, socket_type type, protocol_type protocol)
+        : family_(family), type_(type), protocol_(protocol), socket_(s), is_connected_(true)
+    {
+    }
+
     socket::~socket()
     {
         close();
     }
 
+    std::shared_ptr<socket> socket::adopt(native_handle_type s, protocol_type protocol)
+    {
+        validate_native_handle(s);
+        // Owning the descriptor first closes it if it turns out not to be a usable socket.
+        auto result = std::make_shared<socket>(s, address_family::unspecified, socket_type::stream, protocol);
+        result->type_ = static_cast<socket_type>(result->get_socket_option<int>(SOL_SOCKET, SO_TYPE));
+        sockaddr_storage storage = {0};
+#ifdef _WIN32
+        int length = sizeof(storage);
+#else
+        socklen_t length = sizeof(storage);
+#endif
+
+        if (getsockname(s, reinterpret_cast<sockaddr*>(&storage), &length) != 0)
+        {
+            throw_error("getsockname");
+        }
+
+        result->family_ = static_cast<address_family>(storage.ss_family);
+        length = sizeof(storage);
+        result->is_connected_ = getpeername(s, reinterpret_cast<sockaddr*>(&storage), &length) == 0;
+        result->is_bound_ = result->is_connected_ || result->listening();
+#ifndef _WIN32
+        // The blocking mode belongs to the descriptor and comes along with it.
+        auto flags = fcntl(s, F_GETFL);
+
+        if (flags == -1)
+        {
+            throw_error("fcntl");
+        }
+
+        result->is_blocking_ = (flags & O_NONBLOCK) == 0;
+#endif
+        return result;
+    }
+
     bool socket::valid() const
     {
         return is_valid_native_handle(socket_);
@@ -73,6 +438,12 @@ namespace exa
         return is_bound_;
     }
 
+    bool socket::listening() const
+    {
+        validate_native_handle(socket_);
+        return get_socket_option<int>(SOL_SOCKET, SO_ACCEPTCONN) != 0;
+    }
+
     address_family socket::family() const
     {
         validate_native_handle(socket_);
@@ -222,6 +593,130 @@ namespace exa
 #endif
     }
 
+    bool socket::reuse_port() const
+    {
+        validate_native_handle(socket_);
+#ifdef SO_REUSEPORT
+        return get_socket_option<int>(SOL_SOCKET, SO_REUSEPORT) != 0;
+#else
+        return false;
+#endif
+    }
+
+    void socket::reuse_port(bool value)
+    {
+        validate_native_handle(socket_);
+#ifdef SO_REUSEPORT
+        set_socket_option(SOL_SOCKET, SO_REUSEPORT, value ? 1 : 0);
+#else
+        if (value)
+        {
+            throw std::runtime_error("Reusing ports isn't supported on this platform.");
+        }
+#endif
+    }
+
+    void socket::reuse_port_cpu_steering(size_t group_size)
+    {
+        validate_native_handle(socket_);
+
+        if (group_size == 0 || group_size > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::out_of_range("Reuse port group size is out of range.");
+        }
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+        std::array<sock_filter, 3> code = {{
+            {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+            {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(group_size)},
+            {BPF_RET | BPF_A, 0, 0, 0},
+        }};
+        sock_fprog program = {static_cast<unsigned short>(code.size()), code.data()};
+        set_socket_option(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, program);
+#else
+        throw std::runtime_error("Reuse port steering isn't supported on this platform.");
+#endif
+    }
+
+    bool socket::bind_address_no_port() const
+    {
+        validate_native_handle(socket_);
+#ifdef IP_BIND_ADDRESS_NO_PORT
+        return get_socket_option<int>(IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT) != 0;
+#else
+        return false;
+#endif
+    }
+
+    void socket::bind_address_no_port(bool value)
+    {
+        validate_native_handle(socket_);
+#ifdef IP_BIND_ADDRESS_NO_PORT
+        set_socket_option(IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, value ? 1 : 0);
+#else
+        if (value)
+        {
+            throw std::runtime_error("Binding without a port isn't supported on this platform.");
+        }
+#endif
+    }
+
+    port_range socket::local_port_range() const
+    {
+        validate_native_handle(socket_);
+#ifdef IP_LOCAL_PORT_RANGE
+        try
+        {
+            auto v = get_socket_option<uint32_t>(IPPROTO_IP, IP_LOCAL_PORT_RANGE);
+            return port_range{static_cast<uint16_t>(v & 0xffff), static_cast<uint16_t>(v >> 16)};
+        }
+        catch (const std::system_error& e)
+        {
+            if (e.code() != std::errc::no_protocol_option)
+            {
+                throw;
+            }
+
+            return port_range();
+        }
+#else
+        return port_range();
+#endif
+    }
+
+    void socket::local_port_range(const port_range& range)
+    {
+        validate_native_handle(socket_);
+
+        if (range.low != 0 && range.high != 0 && range.low > range.high)
+        {
+            throw std::invalid_argument("Lower bound of port range is above its upper bound.");
+        }
+
+#ifdef IP_LOCAL_PORT_RANGE
+        try
+        {
+            set_socket_option(IPPROTO_IP, IP_LOCAL_PORT_RANGE,
+                              static_cast<uint32_t>(range.low) | (static_cast<uint32_t>(range.high) << 16));
+        }
+        catch (const std::system_error& e)
+        {
+            // Kernels before 6.3 don't know the option, the range itself was already checked above.
+            if (e.code() == std::errc::no_protocol_option || e.code() == std::errc::invalid_argument)
+            {
+                throw std::runtime_error("Local port ranges aren't supported on this platform.");
+            }
+
+            throw;
+        }
+#else
+        if (range.low != 0 || range.high != 0)
+        {
+            throw std::runtime_error("Local port ranges aren't supported on this platform.");
+        }
+#endif
+    }
+
     std::chrono::seconds socket::ttl() const
     {
         validate_native_handle(socket_);
@@ -260,6 +755,7 @@ namespace exa
         v.l_linger = static_cast<decltype(linger::l_linger)>(value.linger_time.count());
         v.l_onoff = value.enabled ? 1 : 0;
         set_socket_option(SOL_SOCKET, SO_LINGER, v);
+        tuning_.linger_state = value;
     }
 
     bool socket::no_delay() const
@@ -272,327 +768,1423 @@ namespace exa
     {
         validate_native_handle(socket_);
         set_socket_option(IPPROTO_TCP, TCP_NODELAY, value ? 1 : 0);
+        tuning_.no_delay = value;
     }
 
-    endpoint socket::local_endpoint() const
+    bool socket::quick_ack() const
     {
         validate_native_handle(socket_);
-        sockaddr_storage storage = {0};
-#ifdef _WIN32
-        int length = sizeof(storage);
+#ifdef TCP_QUICKACK
+        return get_socket_option<int>(IPPROTO_TCP, TCP_QUICKACK) != 0;
 #else
-        socklen_t length = sizeof(storage);
+        return false;
 #endif
-        auto rc = getsockname(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
-
-        if (rc != 0)
-        {
-            throw_error("getsockname");
-        }
-
-        return endpoint(storage);
     }
 
-    endpoint socket::remote_endpoint() const
+    void socket::quick_ack(bool value)
     {
         validate_native_handle(socket_);
-        sockaddr_storage storage = {0};
-#ifdef _WIN32
-        int length = sizeof(storage);
+#ifdef TCP_QUICKACK
+        // The kernel may leave quick ack mode on its own, the cached value only tells what was requested.
+        set_socket_option(IPPROTO_TCP, TCP_QUICKACK, value ? 1 : 0);
+        tuning_.quick_ack = value;
 #else
-        socklen_t length = sizeof(storage);
+        throw std::runtime_error("TCP quick ack isn't supported on this platform.");
 #endif
-        auto rc = getpeername(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
+    }
 
-        if (rc != 0)
-        {
-            throw_error("getpeername");
-        }
+    bool socket::cork() const
+    {
+        validate_native_handle(socket_);
+#ifdef TCP_CORK
+        return get_socket_option<int>(IPPROTO_TCP, TCP_CORK) != 0;
+#else
+        return false;
+#endif
+    }
 
-        return endpoint(storage);
+    void socket::cork(bool value)
+    {
+        validate_native_handle(socket_);
+#ifdef TCP_CORK
+        set_socket_option(IPPROTO_TCP, TCP_CORK, value ? 1 : 0);
+        tuning_.cork = value;
+#else
+        throw std::runtime_error("TCP cork isn't supported on this platform.");
+#endif
     }
 
-    size_t socket::send_buffer() const
+    size_t socket::not_sent_low_water() const
     {
         validate_native_handle(socket_);
-        return static_cast<size_t>(get_socket_option<int>(SOL_SOCKET, SO_SNDBUF));
+#ifdef TCP_NOTSENT_LOWAT
+        return static_cast<size_t>(get_socket_option<unsigned int>(IPPROTO_TCP, TCP_NOTSENT_LOWAT));
+#else
+        return 0;
+#endif
     }
 
-    void socket::send_buffer(size_t value)
+    void socket::not_sent_low_water(size_t value)
     {
         validate_native_handle(socket_);
-        set_socket_option(SOL_SOCKET, SO_SNDBUF, static_cast<int>(value));
+#ifdef TCP_NOTSENT_LOWAT
+        set_socket_option(IPPROTO_TCP, TCP_NOTSENT_LOWAT, static_cast<unsigned int>(value));
+        tuning_.not_sent_low_water = value;
+#else
+        throw std::runtime_error("TCP not sent low water mark isn't supported on this platform.");
+#endif
     }
 
-    size_t socket::receive_buffer() const
+    size_t socket::receive_low_water() const
     {
         validate_native_handle(socket_);
-        return static_cast<size_t>(get_socket_option<int>(SOL_SOCKET, SO_RCVBUF));
+        return static_cast<size_t>(get_socket_option<int>(SOL_SOCKET, SO_RCVLOWAT));
     }
 
-    void socket::receive_buffer(size_t value)
+    void socket::receive_low_water(size_t value)
     {
         validate_native_handle(socket_);
-        set_socket_option(SOL_SOCKET, SO_RCVBUF, static_cast<int>(value));
+        set_socket_option(SOL_SOCKET, SO_RCVLOWAT, static_cast<int>(value));
+        tuning_.receive_low_water = receive_low_water();
     }
 
-    std::chrono::milliseconds socket::send_timeout() const
+    std::chrono::microseconds socket::busy_poll() const
     {
         validate_native_handle(socket_);
-#ifdef _WIN32
-        return std::chrono::milliseconds(get_socket_option<int>(SOL_SOCKET, SO_SNDTIMEO));
+#ifdef SO_BUSY_POLL
+        return std::chrono::microseconds(get_socket_option<int>(SOL_SOCKET, SO_BUSY_POLL));
 #else
-        auto timeout = get_socket_option<timeval>(SOL_SOCKET, SO_SNDTIMEO);
-        auto s = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(timeout.tv_sec));
-        auto us = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(timeout.tv_usec));
-        return s + us;
+        return 0us;
 #endif
     }
 
-    void socket::send_timeout(const std::chrono::milliseconds& value)
+    void socket::busy_poll(const std::chrono::microseconds& value)
     {
         validate_native_handle(socket_);
-#ifdef _WIN32
-        set_socket_option(SOL_SOCKET, SO_SNDTIMEO, static_cast<int>(value.count()));
+#ifdef SO_BUSY_POLL
+        set_socket_option(SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(value.count()));
+        tuning_.busy_poll = value;
 #else
-        timeval timeout;
-        timeout.tv_sec =
-            static_cast<decltype(timeout.tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
-        timeout.tv_usec = std::clamp<decltype(timeout.tv_usec)>(
-            std::chrono::duration_cast<std::chrono::microseconds>(value).count(), -999999, 999999);
-        set_socket_option(SOL_SOCKET, SO_SNDTIMEO, timeout);
+        throw std::runtime_error("Busy polling isn't supported on this platform.");
 #endif
     }
 
-    std::chrono::milliseconds socket::receive_timeout() const
+    int socket::incoming_cpu() const
     {
         validate_native_handle(socket_);
-#ifdef _WIN32
-        return std::chrono::milliseconds(get_socket_option<int>(SOL_SOCKET, SO_RCVTIMEO));
+#ifdef SO_INCOMING_CPU
+        return get_socket_option<int>(SOL_SOCKET, SO_INCOMING_CPU);
 #else
-        auto timeout = get_socket_option<timeval>(SOL_SOCKET, SO_RCVTIMEO);
-        auto s = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(timeout.tv_sec));
-        auto us = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(timeout.tv_usec));
-        return s + us;
+        return -1;
 #endif
     }
 
-    void socket::receive_timeout(const std::chrono::milliseconds& value)
+    void socket::incoming_cpu(int value)
     {
         validate_native_handle(socket_);
-#ifdef _WIN32
-        set_socket_option(SOL_SOCKET, SO_RCVTIMEO, static_cast<int>(value.count()));
+#ifdef SO_INCOMING_CPU
+        set_socket_option(SOL_SOCKET, SO_INCOMING_CPU, value);
+        tuning_.incoming_cpu = value;
 #else
-        timeval timeout;
-        timeout.tv_sec =
-            static_cast<decltype(timeout.tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
-        timeout.tv_usec = std::clamp<decltype(timeout.tv_usec)>(
-            std::chrono::duration_cast<std::chrono::microseconds>(value).count(), -999999, 999999);
-        set_socket_option(SOL_SOCKET, SO_RCVTIMEO, timeout);
+        throw std::runtime_error("Incoming CPU isn't supported on this platform.");
 #endif
     }
 
-    std::shared_ptr<socket> socket::accept() const
+    size_t socket::fast_open() const
+    {
+        validate_native_handle(socket_);
+#ifdef TCP_FASTOPEN
+        return static_cast<size_t>(get_socket_option<int>(IPPROTO_TCP, TCP_FASTOPEN));
+#else
+        return 0;
+#endif
+    }
+
+    void socket::fast_open(size_t queue_length)
     {
         validate_native_handle(socket_);
+#ifdef TCP_FASTOPEN
+        set_socket_option(IPPROTO_TCP, TCP_FASTOPEN, static_cast<int>(queue_length));
+#else
+        if (queue_length > 0)
+        {
+            throw std::runtime_error("TCP fast open isn't supported on this platform.");
+        }
+#endif
+    }
 
-        sockaddr_storage storage = {0};
-#ifdef _WIN32
-        int length = sizeof(storage);
+    std::chrono::seconds socket::defer_accept() const
+    {
+        validate_native_handle(socket_);
+#ifdef TCP_DEFER_ACCEPT
+        return std::chrono::seconds(get_socket_option<int>(IPPROTO_TCP, TCP_DEFER_ACCEPT));
 #else
-        socklen_t length = sizeof(storage);
+        return std::chrono::seconds(0);
 #endif
-        auto s = ::accept(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
+    }
 
-        if (!is_valid_native_handle(s))
+    void socket::defer_accept(const std::chrono::seconds& timeout)
+    {
+        validate_native_handle(socket_);
+
+        if (timeout.count() < 0 || timeout.count() > std::numeric_limits<int>::max())
         {
-            throw_error("accept");
+            throw std::out_of_range("Defer accept timeout is out of range.");
         }
 
-        return std::make_shared<socket>(s, static_cast<address_family>(storage.ss_family), protocol_type::tcp);
+#ifdef TCP_DEFER_ACCEPT
+        set_socket_option(IPPROTO_TCP, TCP_DEFER_ACCEPT, static_cast<int>(timeout.count()));
+#else
+        if (timeout.count() > 0)
+        {
+            throw std::runtime_error("TCP defer accept isn't supported on this platform.");
+        }
+#endif
     }
 
-    std::future<std::shared_ptr<socket>> socket::accept_async() const
+    bool socket::receive_offload() const
     {
         validate_native_handle(socket_);
+#ifdef UDP_GRO
+        return get_socket_option<int>(SOL_UDP, UDP_GRO) != 0;
+#else
+        return false;
+#endif
+    }
 
-        return detail::io_task::run<std::shared_ptr<socket>>([this] {
-            return poll(0us, select_mode::read) ? std::make_tuple(true, accept())
-                                                : std::make_tuple(false, std::shared_ptr<socket>());
-        });
+    void socket::receive_offload(bool value)
+    {
+        validate_native_handle(socket_);
+#ifdef UDP_GRO
+        set_socket_option(SOL_UDP, UDP_GRO, value ? 1 : 0);
+#else
+        if (value)
+        {
+            throw std::runtime_error("UDP receive offload isn't supported on this platform.");
+        }
+#endif
     }
 
-    void socket::bind(const address& addr, uint16_t port)
+    bool socket::timestamping() const
     {
-        bind(endpoint(addr, port));
+        validate_native_handle(socket_);
+#ifdef SO_TIMESTAMPING
+        return get_socket_option<int>(SOL_SOCKET, SO_TIMESTAMPING) != 0;
+#else
+        return false;
+#endif
     }
 
-    void socket::bind(const endpoint& local_ep)
+    void socket::timestamping(bool value)
     {
         validate_native_handle(socket_);
-        auto storage = local_ep.serialize();
-        int rc = ::bind(socket_, reinterpret_cast<const sockaddr*>(storage.data()), static_cast<int>(storage.size()));
+#ifdef SO_TIMESTAMPING
+        set_socket_option(SOL_SOCKET, SO_TIMESTAMPING, value ? timestamping_flags : 0);
 
-        if (rc != 0)
+        if (error_queue_ == nullptr)
         {
-            throw_error("bind");
+            error_queue_ = std::make_shared<error_queue_context>();
         }
-        else
+
+        lock(*error_queue_, [&] {
+            error_queue_->timestamping = value;
+            error_queue_->timestamp_keys = false;
+        });
+#else
+        if (value)
         {
-            is_bound_ = true;
+            throw std::runtime_error("Timestamping isn't supported on this platform.");
         }
+#endif
     }
 
-    void socket::close()
+    bool socket::zero_copy() const
     {
-#ifdef _WIN32
-        if (socket_ != INVALID_SOCKET)
+        validate_native_handle(socket_);
+#ifdef SO_ZEROCOPY
+        return get_socket_option<int>(SOL_SOCKET, SO_ZEROCOPY) != 0;
+#else
+        return false;
+#endif
+    }
+
+    void socket::zero_copy(bool value)
+    {
+        validate_native_handle(socket_);
+#ifdef SO_ZEROCOPY
+        set_socket_option(SOL_SOCKET, SO_ZEROCOPY, value ? 1 : 0);
+
+        if (error_queue_ == nullptr)
         {
-            closesocket(socket_);
-            socket_ = INVALID_SOCKET;
+            error_queue_ = std::make_shared<error_queue_context>();
         }
+
+        lock(*error_queue_, [&] { error_queue_->zero_copy = value; });
 #else
-        if (socket_ != -1)
+        if (value)
         {
-            ::close(socket_);
-            socket_ = -1;
+            throw std::runtime_error("Zero copy send isn't supported on this platform.");
         }
 #endif
     }
 
-    void socket::close(const std::chrono::seconds& wait_before_close)
+    socket_tcp_info socket::tcp_info() const
     {
         validate_native_handle(socket_);
-        linger_state(linger_option{true, wait_before_close});
-        close();
+#ifdef TCP_INFO
+        // Older kernels fill less of the structure, the remaining fields stay zero.
+        kernel_tcp_info info = {0};
+        socklen_t length = sizeof(info);
+
+        if (getsockopt(socket_, IPPROTO_TCP, TCP_INFO, &info, &length) != 0)
+        {
+            throw_error("getsockopt");
+        }
+
+        socket_tcp_info result;
+        result.state = info.state;
+        result.rtt = std::chrono::microseconds(info.rtt);
+        result.rtt_variance = std::chrono::microseconds(info.rttvar);
+        result.min_rtt = std::chrono::microseconds(info.min_rtt);
+        result.retransmits = info.total_retrans;
+        result.lost = info.lost;
+        result.congestion_window = info.snd_cwnd;
+        result.slow_start_threshold = info.snd_ssthresh;
+        result.send_mss = info.snd_mss;
+        result.pacing_rate = info.pacing_rate;
+        result.delivery_rate = info.delivery_rate;
+        auto in_flight = static_cast<int64_t>(info.unacked) - info.sacked - info.lost + info.retrans;
+        result.bytes_in_flight = static_cast<size_t>(std::max<int64_t>(in_flight, 0)) * info.snd_mss;
+        result.not_sent_bytes = info.notsent_bytes;
+        result.bytes_sent = info.bytes_sent;
+        result.bytes_acked = info.bytes_acked;
+        result.bytes_received = info.bytes_received;
+        result.bytes_retransmitted = info.bytes_retrans;
+        return result;
+#else
+        throw std::runtime_error("TCP connection info isn't supported on this platform.");
+#endif
     }
 
-    void socket::connect(const endpoint& remote_ep)
+    endpoint socket::local_endpoint() const
     {
         validate_native_handle(socket_);
-        auto storage = remote_ep.serialize();
-        int rc = ::connect(socket_, reinterpret_cast<const sockaddr*>(storage.data()), static_cast<int>(storage.size()));
+        sockaddr_storage storage = {0};
+#ifdef _WIN32
+        int length = sizeof(storage);
+#else
+        socklen_t length = sizeof(storage);
+#endif
+        auto rc = getsockname(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
 
         if (rc != 0)
         {
-            throw_error("connect");
+            throw_error("getsockname");
         }
-        else
+
+        return endpoint(storage, static_cast<size_t>(length));
+    }
+
+    endpoint socket::remote_endpoint() const
+    {
+        validate_native_handle(socket_);
+        sockaddr_storage storage = {0};
+#ifdef _WIN32
+        int length = sizeof(storage);
+#else
+        socklen_t length = sizeof(storage);
+#endif
+        auto rc = getpeername(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
+
+        if (rc != 0)
         {
-            is_connected_ = true;
+            throw_error("getpeername");
         }
+
+        return endpoint(storage, static_cast<size_t>(length));
     }
 
-    std::future<void> socket::connect_async(const endpoint& remote_ep)
+    size_t socket::send_buffer() const
     {
         validate_native_handle(socket_);
-        return task::run([=] { return connect(remote_ep); });
+        return static_cast<size_t>(get_socket_option<int>(SOL_SOCKET, SO_SNDBUF));
     }
 
-    void socket::connect(const address& addr, uint16_t port)
+    void socket::send_buffer(size_t value)
     {
-        connect(endpoint(addr, port));
+        validate_native_handle(socket_);
+        set_socket_option(SOL_SOCKET, SO_SNDBUF, static_cast<int>(value));
+        // Linux doubles the size for its bookkeeping and clamps it, the cache holds what the kernel applied.
+        tuning_.send_buffer = send_buffer();
     }
 
-    std::future<void> socket::connect_async(const address& addr, uint16_t port)
+    size_t socket::receive_buffer() const
     {
-        return connect_async(endpoint(addr, port));
+        validate_native_handle(socket_);
+        return static_cast<size_t>(get_socket_option<int>(SOL_SOCKET, SO_RCVBUF));
     }
 
-    void socket::connect(const std::string& host, uint16_t port)
+    void socket::receive_buffer(size_t value)
     {
-        auto endpoints = endpoint::get_address_info(host, std::to_string(port));
-        connect(endpoints);
+        validate_native_handle(socket_);
+        set_socket_option(SOL_SOCKET, SO_RCVBUF, static_cast<int>(value));
+        tuning_.receive_buffer = receive_buffer();
     }
 
-    std::future<void> socket::connect_async(const std::string& host, uint16_t port)
+    std::chrono::milliseconds socket::send_timeout() const
     {
-        return task::run([=] { connect(host, port); });
+        validate_native_handle(socket_);
+#ifdef _WIN32
+        return std::chrono::milliseconds(get_socket_option<int>(SOL_SOCKET, SO_SNDTIMEO));
+#else
+        auto timeout = get_socket_option<timeval>(SOL_SOCKET, SO_SNDTIMEO);
+        auto s = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(timeout.tv_sec));
+        auto us = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(timeout.tv_usec));
+        return s + us;
+#endif
     }
 
-    void socket::connect(gsl::span<const endpoint> endpoints)
+    void socket::send_timeout(const std::chrono::milliseconds& value)
     {
-        for (auto&& ep : endpoints)
-        {
-            try
-            {
-                connect(ep);
-            }
-            catch (std::system_error&)
-            {
-                // Ignore failure for now.
-            }
+        validate_native_handle(socket_);
+#ifdef _WIN32
+        set_socket_option(SOL_SOCKET, SO_SNDTIMEO, static_cast<int>(value.count()));
+#else
+        timeval timeout;
+        timeout.tv_sec =
+            static_cast<decltype(timeout.tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
+        timeout.tv_usec = std::clamp<decltype(timeout.tv_usec)>(
+            std::chrono::duration_cast<std::chrono::microseconds>(value).count(), -999999, 999999);
+        set_socket_option(SOL_SOCKET, SO_SNDTIMEO, timeout);
+#endif
+    }
 
-            if (is_connected_)
-            {
-                break;
-            }
-        }
+    std::chrono::milliseconds socket::receive_timeout() const
+    {
+        validate_native_handle(socket_);
+#ifdef _WIN32
+        return std::chrono::milliseconds(get_socket_option<int>(SOL_SOCKET, SO_RCVTIMEO));
+#else
+        auto timeout = get_socket_option<timeval>(SOL_SOCKET, SO_RCVTIMEO);
+        auto s = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(timeout.tv_sec));
+        auto us = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(timeout.tv_usec));
+        return s + us;
+#endif
+    }
 
-        if (!is_connected_)
+    void socket::receive_timeout(const std::chrono::milliseconds& value)
+    {
+        validate_native_handle(socket_);
+#ifdef _WIN32
+        set_socket_option(SOL_SOCKET, SO_RCVTIMEO, static_cast<int>(value.count()));
+#else
+        timeval timeout;
+        timeout.tv_sec =
+            static_cast<decltype(timeout.tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(value).count());
+        timeout.tv_usec = std::clamp<decltype(timeout.tv_usec)>(
+            std::chrono::duration_cast<std::chrono::microseconds>(value).count(), -999999, 999999);
+        set_socket_option(SOL_SOCKET, SO_RCVTIMEO, timeout);
+#endif
+    }
+
+    const socket_tuning& socket::tuning() const
+    {
+        return tuning_;
+    }
+
+    void socket::apply(const socket_tuning& tuning)
+    {
+        validate_native_handle(socket_);
+
+        if (tuning.bind_address_no_port)
         {
-            throw std::runtime_error("Couldn't connect to any given endpoint from collection.");
+            bind_address_no_port(*tuning.bind_address_no_port);
+        }
+        if (tuning.local_port_range)
+        {
+            local_port_range(*tuning.local_port_range);
+        }
+        if (tuning.linger_state)
+        {
+            linger_state(*tuning.linger_state);
+        }
+        if (tuning.send_buffer)
+        {
+            send_buffer(*tuning.send_buffer);
+        }
+        if (tuning.receive_buffer)
+        {
+            receive_buffer(*tuning.receive_buffer);
+        }
+        if (tuning.not_sent_low_water)
+        {
+            not_sent_low_water(*tuning.not_sent_low_water);
+        }
+        if (tuning.receive_low_water)
+        {
+            receive_low_water(*tuning.receive_low_water);
         }
+        if (tuning.busy_poll)
+        {
+            busy_poll(*tuning.busy_poll);
+        }
+        if (tuning.incoming_cpu)
+        {
+            incoming_cpu(*tuning.incoming_cpu);
+        }
+        if (tuning.no_delay)
+        {
+            no_delay(*tuning.no_delay);
+        }
+        if (tuning.cork)
+        {
+            cork(*tuning.cork);
+        }
+        if (tuning.quick_ack)
+        {
+            quick_ack(*tuning.quick_ack);
+        }
+    }
+
+    std::shared_ptr<socket> socket::accept() const
+    {
+        std::error_code ec;
+        auto s = accept(ec);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "accept");
+        }
+
+        return s;
+    }
+
+    std::shared_ptr<socket> socket::accept(std::error_code& ec) const
+    {
+        validate_native_handle(socket_);
+
+        sockaddr_storage storage = {0};
+#ifdef _WIN32
+        int length = sizeof(storage);
+#else
+        socklen_t length = sizeof(storage);
+#endif
+#ifdef _WIN32
+        auto s = ::accept(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
+#else
+        auto s = accept4(socket_, reinterpret_cast<sockaddr*>(&storage), &length, SOCK_CLOEXEC);
+#endif
+
+        if (!is_valid_native_handle(s))
+        {
+            ec = last_error();
+            return nullptr;
+        }
+
+        ec.clear();
+        return std::make_shared<socket>(s, static_cast<address_family>(storage.ss_family), type_, protocol_);
+    }
+
+    std::future<std::shared_ptr<socket>> socket::accept_async() const
+    {
+        validate_native_handle(socket_);
+
+        return detail::io_task::run<std::shared_ptr<socket>>([this] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, accept())
+                                                : std::make_tuple(false, std::shared_ptr<socket>());
+        });
+    }
+
+    std::shared_ptr<socket> socket::accept(const socket_tuning& tuning) const
+    {
+        auto s = accept();
+        s->apply(tuning);
+        return s;
+    }
+
+    std::future<std::shared_ptr<socket>> socket::accept_async(const socket_tuning& tuning) const
+    {
+        validate_native_handle(socket_);
+
+        return detail::io_task::run<std::shared_ptr<socket>>([this, tuning] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, accept(tuning))
+                                                : std::make_tuple(false, std::shared_ptr<socket>());
+        });
+    }
+
+    std::vector<std::shared_ptr<socket>> socket::accept_batch(size_t max_count, bool blocking) const
+    {
+        validate_native_handle(socket_);
+
+        if (max_count == 0)
+        {
+            throw std::out_of_range("Accept batch needs room for at least one socket.");
+        }
+
+        std::vector<std::shared_ptr<socket>> sockets;
+
+        while (sockets.size() < max_count)
+        {
+            // A blocking listener would wait for the next connection instead of reporting an empty backlog.
+            if (!sockets.empty() && is_blocking_ && !poll(0us, select_mode::read))
+            {
+                break;
+            }
+
+            sockaddr_storage storage = {0};
+#ifdef _WIN32
+            int length = sizeof(storage);
+            auto s = ::accept(socket_, reinterpret_cast<sockaddr*>(&storage), &length);
+
+            if (s == INVALID_SOCKET)
+            {
+                // Throwing would close the connections accepted so far, the error comes up again on the next call.
+                if (!sockets.empty())
+                {
+                    break;
+                }
+
+                throw_error("accept");
+            }
+#else
+            socklen_t length = sizeof(storage);
+            auto s = accept4(socket_, reinterpret_cast<sockaddr*>(&storage), &length,
+                             SOCK_CLOEXEC | (blocking ? 0 : SOCK_NONBLOCK));
+
+            if (s == -1)
+            {
+                if (errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                // Throwing would close the connections accepted so far, the error comes up again on the next call.
+                if (!sockets.empty())
+                {
+                    break;
+                }
+
+                throw_error("accept4");
+            }
+#endif
+
+            auto client = std::make_shared<socket>(s, static_cast<address_family>(storage.ss_family), type_, protocol_);
+#ifdef _WIN32
+            if (!blocking)
+            {
+                client->blocking(false);
+            }
+#else
+            client->is_blocking_ = blocking;
+#endif
+            sockets.push_back(std::move(client));
+        }
+
+        return sockets;
+    }
+
+    std::future<std::vector<std::shared_ptr<socket>>> socket::accept_batch_async(size_t max_count, bool blocking) const
+    {
+        validate_native_handle(socket_);
+
+        return detail::io_task::run<std::vector<std::shared_ptr<socket>>>([=] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, accept_batch(max_count, blocking))
+                                                : std::make_tuple(false, std::vector<std::shared_ptr<socket>>());
+        });
+    }
+
+    void socket::bind(const address& addr, uint16_t port)
+    {
+        bind(endpoint(addr, port));
+    }
+
+    void socket::bind(const endpoint& local_ep)
+    {
+        validate_native_handle(socket_);
+        auto storage = local_ep.serialize();
+        int rc = ::bind(socket_, reinterpret_cast<const sockaddr*>(storage.data()), static_cast<int>(storage.size()));
+
+        if (rc != 0)
+        {
+            throw_error("bind");
+        }
+        else
+        {
+            is_bound_ = true;
+        }
+    }
+
+    void socket::close()
+    {
+#ifdef _WIN32
+        if (socket_ != INVALID_SOCKET)
+        {
+            closesocket(socket_);
+            socket_ = INVALID_SOCKET;
+        }
+#else
+        if (socket_ != -1)
+        {
+            ::close(socket_);
+            socket_ = -1;
+        }
+#endif
+    }
+
+    void socket::close(const std::chrono::seconds& wait_before_close)
+    {
+        validate_native_handle(socket_);
+        linger_state(linger_option{true, wait_before_close});
+        close();
+    }
+
+    void socket::connect(const endpoint& remote_ep)
+    {
+        std::error_code ec;
+        connect(remote_ep, ec);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "connect");
+        }
+    }
+
+    void socket::connect(const endpoint& remote_ep, std::error_code& ec)
+    {
+        validate_native_handle(socket_);
+        auto storage = remote_ep.serialize();
+        int rc = ::connect(socket_, reinterpret_cast<const sockaddr*>(storage.data()), static_cast<int>(storage.size()));
+
+        if (rc != 0)
+        {
+            ec = last_error();
+        }
+        else
+        {
+            ec.clear();
+            is_connected_ = true;
+        }
+    }
+
+    std::future<void> socket::connect_async(const endpoint& remote_ep)
+    {
+        validate_native_handle(socket_);
+        return task::run([=] { return connect(remote_ep); });
+    }
+
+    size_t socket::connect(const endpoint& remote_ep, gsl::span<const uint8_t> data)
+    {
+        validate_native_handle(socket_);
+
+        if (data.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffer is null.");
+        }
+
+#ifdef MSG_FASTOPEN
+        auto storage = remote_ep.serialize();
+        auto n = sendto(socket_, data.data(), static_cast<size_t>(data.size()), MSG_FASTOPEN,
+                        reinterpret_cast<const sockaddr*>(storage.data()), static_cast<socklen_t>(storage.size()));
+
+        if (n != -1)
+        {
+            is_connected_ = true;
+            return static_cast<size_t>(n);
+        }
+        if (errno != EOPNOTSUPP)
+        {
+            throw_error("sendto");
+        }
+#endif
+        // Fast open is disabled on this system, fall back to a regular handshake.
+        connect(remote_ep);
+        return send(data);
+    }
+
+    std::future<size_t> socket::connect_async(const endpoint& remote_ep, gsl::span<const uint8_t> data)
+    {
+        validate_native_handle(socket_);
+        return task::run([=] { return connect(remote_ep, data); });
+    }
+
+    void socket::connect(const address& addr, uint16_t port)
+    {
+        connect(endpoint(addr, port));
+    }
+
+    std::future<void> socket::connect_async(const address& addr, uint16_t port)
+    {
+        return connect_async(endpoint(addr, port));
+    }
+
+    void socket::connect(const std::string& host, uint16_t port)
+    {
+        auto endpoints = endpoint::get_address_info(host, std::to_string(port));
+        connect(endpoints);
+    }
+
+    std::future<void> socket::connect_async(const std::string& host, uint16_t port)
+    {
+        return task::run([=] { connect(host, port); });
+    }
+
+    void socket::connect(gsl::span<const endpoint> endpoints)
+    {
+        for (auto&& ep : endpoints)
+        {
+            try
+            {
+                connect(ep);
+            }
+            catch (std::system_error&)
+            {
+                // Ignore failure for now.
+            }
+
+            if (is_connected_)
+            {
+                break;
+            }
+        }
+
+        if (!is_connected_)
+        {
+            throw std::runtime_error("Couldn't connect to any given endpoint from collection.");
+        }
+    }
+
+    std::future<void> socket::connect_async(gsl::span<const endpoint> endpoints)
+    {
+        return task::run([=] { connect(endpoints); });
+    }
+
+    void socket::listen(size_t backlog) const
+    {
+        validate_native_handle(socket_);
+        auto rc = ::listen(socket_, static_cast<int>(backlog));
+
+        if (rc != 0)
+        {
+            throw_error("listen");
+        }
+    }
+
+    bool socket::poll(const std::chrono::microseconds& us, select_mode mode) const
+    {
+        validate_native_handle(socket_);
+
+#ifdef _WIN32
+        WSAPOLLFD descriptor = {socket_, to_poll_events(mode), 0};
+        auto rc = WSAPoll(&descriptor, 1, to_poll_timeout(us));
+#else
+        pollfd descriptor = {socket_, to_poll_events(mode), 0};
+        auto rc = ::poll(&descriptor, 1, to_poll_timeout(us));
+#endif
+
+        validate_transfer(rc, "poll");
+        return is_poll_ready(mode, descriptor.revents);
+    }
+
+    size_t socket::receive(gsl::span<uint8_t> buffer, socket_flags flags) const
+    {
+        std::error_code ec;
+        auto n = receive(buffer, ec, flags);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "recv");
+        }
+
+        return n;
+    }
+
+    size_t socket::receive(gsl::span<uint8_t> buffer, std::error_code& ec, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffer is null.");
+        }
+
+        auto n = recv(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
+                      static_cast<std::underlying_type_t<socket_flags>>(flags));
+        return check_transfer(n, ec);
+    }
+
+    std::future<size_t> socket::receive_async(gsl::span<uint8_t> buffer, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, receive(buffer, flags))
+                                                : std::make_tuple(false, static_cast<size_t>(0));
+        });
+    }
+
+    size_t socket::receive(gsl::span<uint8_t> buffer, socket_timestamp& timestamp, socket_flags flags) const
+    {
+        timestamp = socket_timestamp();
+#ifdef SO_TIMESTAMPING
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffer is null.");
+        }
+
+        socklen_t length = 0;
+        auto n = receive_timestamped(socket_, buffer, nullptr, length, timestamp,
+                                     static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "recvmsg");
+        return static_cast<size_t>(n);
+#else
+        return receive(buffer, flags);
+#endif
+    }
+
+    size_t socket::receive(gsl::span<const gsl::span<uint8_t>> buffers, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffers are null.");
+        }
+
+        io_buffers<uint8_t> b(buffers);
+#ifdef _WIN32
+        DWORD n = 0;
+        DWORD f = static_cast<DWORD>(flags);
+        auto rc = WSARecv(socket_, b.data(), static_cast<DWORD>(b.size()), &n, &f, nullptr, nullptr);
+        validate_transfer(rc, "WSARecv");
+#else
+        msghdr message = {0};
+        message.msg_iov = b.data();
+        message.msg_iovlen = b.size();
+        auto n = recvmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "recvmsg");
+#endif
+        return static_cast<size_t>(n);
+    }
+
+    std::future<size_t> socket::receive_async(gsl::span<const gsl::span<uint8_t>> buffers, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, receive(buffers, flags))
+                                                : std::make_tuple(false, static_cast<size_t>(0));
+        });
+    }
+
+    size_t socket::receive_from(gsl::span<uint8_t> buffer, endpoint& ep, socket_flags flags) const
+    {
+        std::error_code ec;
+        auto n = receive_from(buffer, ep, ec, flags);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "recvfrom");
+        }
+
+        return n;
+    }
+
+    size_t socket::receive_from(gsl::span<uint8_t> buffer, endpoint& ep, std::error_code& ec, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffer is null.");
+        }
+
+        sockaddr_storage storage = {0};
+#ifdef _WIN32
+        int length = sizeof(storage);
+#else
+        socklen_t length = sizeof(storage);
+#endif
+        auto n = recvfrom(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
+                          static_cast<std::underlying_type_t<socket_flags>>(flags), reinterpret_cast<sockaddr*>(&storage),
+                          &length);
+        auto received = check_transfer(n, ec);
+
+        if (!ec)
+        {
+            ep = endpoint(storage, static_cast<size_t>(length));
+        }
+
+        return received;
+    }
+
+    size_t socket::receive_from(gsl::span<uint8_t> buffer, endpoint& ep, socket_timestamp& timestamp,
+                                socket_flags flags) const
+    {
+        timestamp = socket_timestamp();
+#ifdef SO_TIMESTAMPING
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffer is null.");
+        }
+
+        sockaddr_storage name = {0};
+        socklen_t length = 0;
+        auto n = receive_timestamped(socket_, buffer, &name, length, timestamp,
+                                     static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "recvmsg");
+
+        // Connected stream sockets don't report a source address.
+        ep = name.ss_family != AF_UNSPEC ? endpoint(name, length) : remote_endpoint();
+        return static_cast<size_t>(n);
+#else
+        return receive_from(buffer, ep, flags);
+#endif
+    }
+
+    std::future<socket_receive_from_result> socket::receive_from_async(gsl::span<uint8_t> buffer, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        return detail::io_task::run<socket_receive_from_result>([=] {
+            if (poll(0us, select_mode::read))
+            {
+                endpoint ep;
+                auto n = receive_from(buffer, ep, flags);
+                return std::make_tuple(true, socket_receive_from_result{n, ep});
+            }
+            else
+            {
+                return std::make_tuple(false, socket_receive_from_result());
+            }
+        });
+    }
+
+    size_t socket::send(gsl::span<const uint8_t> buffer, socket_flags flags) const
+    {
+        std::error_code ec;
+        auto n = send(buffer, ec, flags);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "send");
+        }
+
+        return n;
+    }
+
+    size_t socket::send(gsl::span<const uint8_t> buffer, std::error_code& ec, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffer is null.");
+        }
+
+        auto n = ::send(socket_, reinterpret_cast<const char*>(buffer.data()), static_cast<int>(buffer.size()),
+                        static_cast<std::underlying_type_t<socket_flags>>(flags));
+        return check_transfer(n, ec);
+    }
+
+    size_t socket::send(gsl::span<const uint8_t> buffer, socket_timestamp& timestamp, socket_flags flags) const
+    {
+        timestamp = socket_timestamp();
+#ifdef SO_TIMESTAMPING
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffer is null.");
+        }
+
+        auto queue = error_queue_;
+        bool enabled = false;
+
+        if (queue != nullptr)
+        {
+            lock(*queue, [&] { enabled = queue->timestamping; });
+        }
+        if (!enabled)
+        {
+            throw std::runtime_error("Timestamping isn't enabled on socket.");
+        }
+
+        iovec b = {const_cast<uint8_t*>(buffer.data()), static_cast<size_t>(buffer.size())};
+        std::array<char, CMSG_SPACE(sizeof(uint32_t))> control = {0};
+        msghdr message = {0};
+        message.msg_iov = &b;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SO_TIMESTAMPING;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
+        uint32_t request = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_HARDWARE;
+        memcpy(CMSG_DATA(cmsg), &request, sizeof(request));
+
+        std::lock_guard<std::mutex> sending(queue->timestamped_send);
+        // Both a software and a hardware report may arrive for one send and reports may get lost, so they're matched
+        // by key instead of by order.
+        auto stream = type_ == socket_type::stream;
+        auto armed = false;
+        lock(*queue, [&] { armed = queue->timestamp_keys; });
+
+        if (!armed)
+        {
+            // Keys can only be turned on for connected stream sockets, so it happens on the first timestamped send.
+            uint32_t base = 0;
+
+            if (stream)
+            {
+                auto written_keys = true;
+                auto before = read_stream_position(socket_);
+
+                set_socket_option(SOL_SOCKET, SO_TIMESTAMPING, timestamping_flags);
+
+                while (true)
+                {
+                    auto value = timestamping_flags | SOF_TIMESTAMPING_OPT_ID;
+                    value |= written_keys ? timestamping_opt_id_tcp : 0;
+
+                    if (setsockopt(socket_, SOL_SOCKET, SO_TIMESTAMPING, &value, sizeof(value)) != 0)
+                    {
+                        if (errno != EINVAL || !written_keys)
+                        {
+                            throw_error("setsockopt");
+                        }
+
+                        // Kernels before 6.2 key by acknowledged bytes.
+                        written_keys = false;
+                        continue;
+                    }
+
+                    auto after = read_stream_position(socket_);
+
+                    if (written_keys || after.acknowledged == before.acknowledged)
+                    {
+                        base = written_keys ? after.written : after.acknowledged;
+                        break;
+                    }
+
+                    // Data got acknowledged while the key was turned on, the kernel only resets it when turning it on.
+                    set_socket_option(SOL_SOCKET, SO_TIMESTAMPING, timestamping_flags);
+                    before = after;
+                }
+            }
+            else
+            {
+                set_socket_option(SOL_SOCKET, SO_TIMESTAMPING, timestamping_flags | SOF_TIMESTAMPING_OPT_ID);
+            }
+
+            lock(*queue, [&] {
+                queue->timestamp_keys = true;
+                queue->timestamp_base = base;
+                queue->next_timestamp_key = 0;
+            });
+        }
+
+        // Stream reports are keyed by the position of the last byte sent.
+        uint32_t written = stream ? read_stream_position(socket_).written : 0;
+
+        lock(*queue, [&] {
+            queue->reported_timestamp.reset();
+            // Stale reports of abandoned sends have different keys.
+            queue->pending_timestamp =
+                stream ? static_cast<uint32_t>(written - queue->timestamp_base + buffer.size() - 1)
+                       : queue->next_timestamp_key++;
+        });
+
+        auto n = sendmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags));
+        auto error = errno;
+
+        if (n == -1)
+        {
+            lock(*queue, [&] { queue->pending_timestamp.reset(); });
+            throw std::system_error(error, std::system_category(), "sendmsg");
+        }
+        if (stream && static_cast<size_t>(n) != static_cast<size_t>(buffer.size()))
+        {
+            lock(*queue, [&] {
+                queue->pending_timestamp = static_cast<uint32_t>(written - queue->timestamp_base + n - 1);
+            });
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + send_timestamp_timeout;
+
+        while (true)
+        {
+            drain_error_queue();
+
+            bool found = false;
+            lock(*queue, [&] {
+                if (queue->reported_timestamp)
+                {
+                    timestamp = *queue->reported_timestamp;
+                    queue->reported_timestamp.reset();
+                    found = true;
+                }
+            });
+
+            if (found)
+            {
+                return static_cast<size_t>(n);
+            }
+
+            auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+
+            if (left.count() <= 0)
+            {
+                lock(*queue, [&] { queue->pending_timestamp.reset(); });
+                throw std::runtime_error("Send timestamp wasn't reported in time.");
+            }
+
+            poll(left, select_mode::error);
+        }
+#else
+        return send(buffer, flags);
+#endif
+    }
+
+    std::future<size_t> socket::send_async(gsl::span<const uint8_t> buffer, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::write) ? std::make_tuple(true, send(buffer, flags))
+                                                 : std::make_tuple(false, static_cast<size_t>(0));
+        });
+    }
+
+    size_t socket::send(gsl::span<const gsl::span<const uint8_t>> buffers, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffers.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffers are null.");
+        }
+
+        io_buffers<const uint8_t> b(buffers);
+#ifdef _WIN32
+        DWORD n = 0;
+        auto rc = WSASend(socket_, b.data(), static_cast<DWORD>(b.size()), &n, static_cast<DWORD>(flags), nullptr, nullptr);
+        validate_transfer(rc, "WSASend");
+#else
+        msghdr message = {0};
+        message.msg_iov = b.data();
+        message.msg_iovlen = b.size();
+        auto n = sendmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "sendmsg");
+#endif
+        return static_cast<size_t>(n);
+    }
+
+    std::future<size_t> socket::send_async(gsl::span<const gsl::span<const uint8_t>> buffers, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::write) ? std::make_tuple(true, send(buffers, flags))
+                                                 : std::make_tuple(false, static_cast<size_t>(0));
+        });
+    }
+
+    std::future<size_t> socket::send_zero_copy_async(gsl::span<const uint8_t> buffer, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffer is null.");
+        }
+
+#ifdef MSG_ZEROCOPY
+        auto queue = error_queue_;
+        bool enabled = false;
+
+        if (queue != nullptr)
+        {
+            lock(*queue, [&] { enabled = queue->zero_copy; });
+        }
+        if (!enabled)
+        {
+            throw std::runtime_error("Zero copy send isn't enabled on socket.");
+        }
+
+        auto sent = std::make_shared<size_t>(0);
+        auto ids = std::make_shared<std::vector<uint32_t>>();
+
+        return detail::io_task::run<size_t>([=] {
+            auto size = static_cast<size_t>(buffer.size());
+
+            if (*sent < size)
+            {
+                if (!poll(0us, select_mode::write))
+                {
+                    return std::make_tuple(false, static_cast<size_t>(0));
+                }
+
+                // The kernel numbers every successful zero copy send, so sending and counting must not interleave.
+                lock(*queue, [&] {
+                    auto rest = buffer.subspan(static_cast<std::ptrdiff_t>(*sent));
+                    auto n = ::send(socket_, rest.data(), static_cast<size_t>(rest.size()),
+                                    static_cast<std::underlying_type_t<socket_flags>>(flags) | MSG_ZEROCOPY | MSG_DONTWAIT);
+
+                    if (n == -1)
+                    {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS)
+                        {
+                            throw_error("send");
+                        }
+
+                        return;
+                    }
+
+                    ids->push_back(queue->next_zero_copy_id);
+                    queue->pending_zero_copy.insert(queue->next_zero_copy_id++);
+                    *sent += static_cast<size_t>(n);
+                });
+
+                if (*sent < size)
+                {
+                    return std::make_tuple(false, static_cast<size_t>(0));
+                }
+            }
+
+            drain_error_queue();
+
+            bool done = true;
+            lock(*queue, [&] {
+                done = std::none_of(std::begin(*ids), std::end(*ids),
+                                    [&](auto id) { return queue->pending_zero_copy.count(id) > 0; });
+            });
+
+            return std::make_tuple(done, done ? *sent : static_cast<size_t>(0));
+        });
+#else
+        // Without zero copy the data is copied on send, so the buffer is free once everything was sent.
+        auto sent = std::make_shared<size_t>(0);
+
+        return detail::io_task::run<size_t>([=] {
+            if (poll(0us, select_mode::write))
+            {
+                *sent += send(buffer.subspan(static_cast<std::ptrdiff_t>(*sent)), flags);
+            }
+
+            auto done = *sent == static_cast<size_t>(buffer.size());
+            return std::make_tuple(done, done ? *sent : static_cast<size_t>(0));
+        });
+#endif
+    }
+
+    size_t socket::send_to(gsl::span<const uint8_t> buffer, const endpoint& ep, socket_flags flags) const
+    {
+        std::error_code ec;
+        auto n = send_to(buffer, ep, ec, flags);
+
+        if (ec)
+        {
+            throw std::system_error(ec, "sendto");
+        }
+
+        return n;
+    }
+
+    size_t socket::send_to(gsl::span<const uint8_t> buffer, const endpoint& ep, std::error_code& ec,
+                           socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Send buffer is null.");
+        }
+
+        auto addr = ep.serialize();
+        auto n = sendto(socket_, reinterpret_cast<const char*>(buffer.data()), static_cast<int>(buffer.size()),
+                        static_cast<std::underlying_type_t<socket_flags>>(flags),
+                        reinterpret_cast<const sockaddr*>(addr.data()), static_cast<int>(addr.size()));
+        return check_transfer(n, ec);
     }
 
-    std::future<void> socket::connect_async(gsl::span<const endpoint> endpoints)
+    std::future<size_t> socket::send_to_async(gsl::span<const uint8_t> buffer, const endpoint& ep, socket_flags flags) const
     {
-        return task::run([=] { connect(endpoints); });
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::write) ? std::make_tuple(true, send_to(buffer, ep, flags))
+                                                 : std::make_tuple(false, static_cast<size_t>(0));
+        });
     }
 
-    void socket::listen(size_t backlog) const
+    size_t socket::send_segments(gsl::span<const uint8_t> buffer, size_t segment_size, const endpoint& ep,
+                                 socket_flags flags) const
     {
         validate_native_handle(socket_);
-        auto rc = ::listen(socket_, static_cast<int>(backlog));
 
-        if (rc != 0)
+        if (buffer.data() == nullptr)
         {
-            throw_error("listen");
+            throw std::invalid_argument("Send buffer is null.");
+        }
+        if (segment_size == 0 || segment_size > std::numeric_limits<uint16_t>::max())
+        {
+            throw std::out_of_range("Segment size must be between 1 and 65535 bytes.");
         }
-    }
-
-    bool socket::poll(const std::chrono::microseconds& us, select_mode mode) const
-    {
-        validate_native_handle(socket_);
-
-        fd_set set;
-        FD_ZERO(&set);
-        FD_SET(socket_, &set);
 
-        timeval timeout;
-        timeout.tv_sec =
-            static_cast<decltype(timeval::tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(us).count());
-        timeout.tv_usec =
-            std::clamp<decltype(timeval::tv_usec)>(static_cast<decltype(timeval::tv_usec)>(us.count()), -999999, 999999);
+#ifdef UDP_SEGMENT
+        iovec b = {const_cast<uint8_t*>(buffer.data()), static_cast<size_t>(buffer.size())};
+        std::array<char, CMSG_SPACE(sizeof(uint16_t))> control = {0};
+        msghdr message = {0};
+        message.msg_iov = &b;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        auto size = static_cast<uint16_t>(segment_size);
+        memcpy(CMSG_DATA(cmsg), &size, sizeof(size));
+
+        sockaddr_storage name;
+
+        if (ep.port() != 0)
+        {
+            auto addr = ep.serialize();
+            memcpy(&name, addr.data(), addr.size());
+            message.msg_name = &name;
+            message.msg_namelen = static_cast<socklen_t>(addr.size());
+        }
 
-#ifdef _WIN32
-        int nfds = 0;
+        auto n = sendmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "sendmsg");
+        return static_cast<size_t>(n);
 #else
-        auto nfds = socket_ + 1;
-#endif
-
-        int rc = 0;
+        // Without segmentation offload every segment becomes its own datagram.
+        size_t n = 0;
 
-        switch (mode)
+        for (std::ptrdiff_t offset = 0; offset < buffer.size(); offset += static_cast<std::ptrdiff_t>(segment_size))
         {
-            case select_mode::error:
-                rc = ::select(nfds, nullptr, nullptr, &set, &timeout);
-                break;
-            case select_mode::read:
-                rc = ::select(nfds, &set, nullptr, nullptr, &timeout);
-                break;
-            case select_mode::write:
-                rc = ::select(nfds, nullptr, &set, nullptr, &timeout);
-                break;
-            default:
-                break;
+            auto segment = buffer.subspan(offset, std::min<std::ptrdiff_t>(segment_size, buffer.size() - offset));
+            n += ep.port() == 0 ? send(segment, flags) : send_to(segment, ep, flags);
         }
 
-        validate_transfer(rc, "select");
-        return FD_ISSET(socket_, &set);
+        return n;
+#endif
     }
 
-    size_t socket::receive(gsl::span<uint8_t> buffer, socket_flags flags) const
+    std::future<size_t> socket::send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size,
+                                                    const endpoint& ep, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::write) ? std::make_tuple(true, send_segments(buffer, segment_size, ep, flags))
+                                                 : std::make_tuple(false, static_cast<size_t>(0));
+        });
+    }
+
+    socket_receive_segments_result socket::receive_segments(gsl::span<uint8_t> buffer, socket_flags flags) const
     {
         validate_native_handle(socket_);
 
@@ -601,110 +2193,323 @@ namespace exa
             throw std::invalid_argument("Receive buffer is null.");
         }
 
-        auto n = recv(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
-                      static_cast<std::underlying_type_t<socket_flags>>(flags));
-        validate_transfer(n, "recv");
-        return static_cast<size_t>(n);
+        socket_receive_segments_result result;
+#ifdef UDP_GRO
+        iovec b = {buffer.data(), static_cast<size_t>(buffer.size())};
+        std::array<char, CMSG_SPACE(sizeof(int))> control = {0};
+        sockaddr_storage name = {0};
+        msghdr message = {0};
+        message.msg_name = &name;
+        message.msg_namelen = sizeof(name);
+        message.msg_iov = &b;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto n = recvmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags));
+        validate_transfer(n, "recvmsg");
+        result.bytes = static_cast<size_t>(n);
+        result.segment_size = result.bytes;
+        result.endpoint = endpoint(name, message.msg_namelen);
+
+        for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int size = 0;
+                memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+                result.segment_size = static_cast<size_t>(size);
+            }
+        }
+#else
+        result.bytes = receive_from(buffer, result.endpoint, flags);
+        result.segment_size = result.bytes;
+#endif
+        return result;
     }
 
-    std::future<size_t> socket::receive_async(gsl::span<uint8_t> buffer, socket_flags flags) const
+    std::future<socket_receive_segments_result> socket::receive_segments_async(gsl::span<uint8_t> buffer,
+                                                                               socket_flags flags) const
     {
         validate_native_handle(socket_);
-        return detail::io_task::run<size_t>([=] {
-            return poll(0us, select_mode::read) ? std::make_tuple(true, receive(buffer, flags))
-                                                : std::make_tuple(false, static_cast<size_t>(0));
+        return detail::io_task::run<socket_receive_segments_result>([=] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, receive_segments(buffer, flags))
+                                                : std::make_tuple(false, socket_receive_segments_result());
         });
     }
 
-    size_t socket::receive_from(gsl::span<uint8_t> buffer, endpoint& ep, socket_flags flags) const
+    size_t socket::receive_batch(gsl::span<socket_receive_message> messages, socket_flags flags) const
     {
         validate_native_handle(socket_);
 
-        if (buffer.data() == nullptr)
+        if (messages.empty())
         {
-            throw std::invalid_argument("Receive buffer is null.");
+            throw std::invalid_argument("Receive batch is empty.");
         }
 
-        sockaddr_storage storage = {0};
+        auto size = static_cast<size_t>(messages.size());
+        size_t count = 0;
 #ifdef _WIN32
-        int length = sizeof(storage);
+        // No recvmmsg on Windows: block for the first datagram, then drain whatever is already queued.
+        while (count < size && (count == 0 || poll(0us, select_mode::read)))
+        {
+            auto& m = messages[static_cast<std::ptrdiff_t>(count)];
+            m.bytes = receive_from(m.buffer, m.endpoint, flags);
+            ++count;
+        }
 #else
-        socklen_t length = sizeof(storage);
-#endif
-        auto n = recvfrom(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
-                          static_cast<std::underlying_type_t<socket_flags>>(flags), reinterpret_cast<sockaddr*>(&storage),
-                          &length);
-        validate_transfer(n, "recvfrom");
-        ep = endpoint(storage);
-        return static_cast<size_t>(n);
-    }
+        std::array<mmsghdr, max_batch_size> headers;
+        std::array<iovec, max_batch_size> buffers;
+        std::array<sockaddr_storage, max_batch_size> names;
+        auto f = static_cast<std::underlying_type_t<socket_flags>>(flags);
 
-    std::future<socket_receive_from_result> socket::receive_from_async(gsl::span<uint8_t> buffer, socket_flags flags) const
-    {
-        validate_native_handle(socket_);
+        while (count < size)
+        {
+            auto n = std::min(size - count, max_batch_size);
 
-        return detail::io_task::run<socket_receive_from_result>([=] {
-            if (poll(0us, select_mode::read))
+            for (size_t i = 0; i < n; ++i)
             {
-                endpoint ep;
-                auto n = receive_from(buffer, ep, flags);
-                return std::make_tuple(true, socket_receive_from_result{n, ep});
+                auto& m = messages[static_cast<std::ptrdiff_t>(count + i)];
+
+                if (m.buffer.data() == nullptr)
+                {
+                    throw std::invalid_argument("Receive buffer is null.");
+                }
+
+                buffers[i].iov_base = m.buffer.data();
+                buffers[i].iov_len = static_cast<size_t>(m.buffer.size());
+                headers[i] = mmsghdr{};
+                headers[i].msg_hdr.msg_name = &names[i];
+                headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+                headers[i].msg_hdr.msg_iov = &buffers[i];
+                headers[i].msg_hdr.msg_iovlen = 1;
             }
-            else
+
+            auto rc = recvmmsg(socket_, headers.data(), static_cast<unsigned int>(n),
+                               count == 0 ? f | MSG_WAITFORONE : f | MSG_DONTWAIT, nullptr);
+
+            if (rc == -1)
             {
-                return std::make_tuple(false, socket_receive_from_result());
+                if (count > 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    break;
+                }
+
+                throw_error("recvmmsg");
+            }
+
+            for (size_t i = 0; i < static_cast<size_t>(rc); ++i)
+            {
+                auto& m = messages[static_cast<std::ptrdiff_t>(count + i)];
+                m.bytes = headers[i].msg_len;
+                m.endpoint = endpoint(names[i], headers[i].msg_hdr.msg_namelen);
+            }
+
+            count += static_cast<size_t>(rc);
+
+            if (static_cast<size_t>(rc) < n)
+            {
+                break;
             }
+        }
+#endif
+        return count;
+    }
+
+    std::future<size_t> socket::receive_batch_async(gsl::span<socket_receive_message> messages, socket_flags flags) const
+    {
+        validate_native_handle(socket_);
+        return detail::io_task::run<size_t>([=] {
+            return poll(0us, select_mode::read) ? std::make_tuple(true, receive_batch(messages, flags))
+                                                : std::make_tuple(false, static_cast<size_t>(0));
         });
     }
 
-    size_t socket::send(gsl::span<const uint8_t> buffer, socket_flags flags) const
+    size_t socket::send_batch(gsl::span<const socket_send_message> messages, socket_flags flags) const
     {
         validate_native_handle(socket_);
 
-        if (buffer.data() == nullptr)
+        if (messages.empty())
         {
-            throw std::invalid_argument("Send buffer is null.");
+            throw std::invalid_argument("Send batch is empty.");
         }
 
-        auto n = ::send(socket_, reinterpret_cast<const char*>(buffer.data()), static_cast<int>(buffer.size()),
-                        static_cast<std::underlying_type_t<socket_flags>>(flags));
-        validate_transfer(n, "send");
-        return static_cast<size_t>(n);
+        auto size = static_cast<size_t>(messages.size());
+        size_t count = 0;
+#ifdef _WIN32
+        for (; count < size; ++count)
+        {
+            auto& m = messages[static_cast<std::ptrdiff_t>(count)];
+
+            if (m.endpoint.port() == 0)
+            {
+                send(m.buffer, flags);
+            }
+            else
+            {
+                send_to(m.buffer, m.endpoint, flags);
+            }
+        }
+#else
+        std::array<mmsghdr, max_batch_size> headers;
+        std::array<iovec, max_batch_size> buffers;
+        std::array<sockaddr_storage, max_batch_size> names;
+        auto f = static_cast<std::underlying_type_t<socket_flags>>(flags);
+
+        while (count < size)
+        {
+            auto n = std::min(size - count, max_batch_size);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto& m = messages[static_cast<std::ptrdiff_t>(count + i)];
+
+                if (m.buffer.data() == nullptr)
+                {
+                    throw std::invalid_argument("Send buffer is null.");
+                }
+
+                buffers[i].iov_base = const_cast<uint8_t*>(m.buffer.data());
+                buffers[i].iov_len = static_cast<size_t>(m.buffer.size());
+                headers[i] = mmsghdr{};
+                headers[i].msg_hdr.msg_iov = &buffers[i];
+                headers[i].msg_hdr.msg_iovlen = 1;
+
+                // Messages without a destination port go to the connected peer.
+                if (m.endpoint.port() != 0)
+                {
+                    auto addr = m.endpoint.serialize();
+                    memcpy(&names[i], addr.data(), addr.size());
+                    headers[i].msg_hdr.msg_name = &names[i];
+                    headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(addr.size());
+                }
+            }
+
+            auto rc = sendmmsg(socket_, headers.data(), static_cast<unsigned int>(n), f);
+
+            if (rc == -1)
+            {
+                if (count > 0)
+                {
+                    break;
+                }
+
+                throw_error("sendmmsg");
+            }
+
+            count += static_cast<size_t>(rc);
+
+            if (static_cast<size_t>(rc) < n)
+            {
+                break;
+            }
+        }
+#endif
+        return count;
     }
 
-    std::future<size_t> socket::send_async(gsl::span<const uint8_t> buffer, socket_flags flags) const
+    std::future<size_t> socket::send_batch_async(gsl::span<const socket_send_message> messages, socket_flags flags) const
     {
         validate_native_handle(socket_);
         return detail::io_task::run<size_t>([=] {
-            return poll(0us, select_mode::write) ? std::make_tuple(true, send(buffer, flags))
+            return poll(0us, select_mode::write) ? std::make_tuple(true, send_batch(messages, flags))
                                                  : std::make_tuple(false, static_cast<size_t>(0));
         });
     }
 
-    size_t socket::send_to(gsl::span<const uint8_t> buffer, const endpoint& ep, socket_flags flags) const
+    size_t socket::send_descriptors(gsl::span<const native_handle_type> descriptors, gsl::span<const uint8_t> data,
+                                    socket_flags flags) const
     {
         validate_native_handle(socket_);
 
-        if (buffer.data() == nullptr)
+        if (data.data() == nullptr || data.empty())
         {
-            throw std::invalid_argument("Send buffer is null.");
+            throw std::invalid_argument("Descriptors need at least one byte of data.");
+        }
+        if (static_cast<size_t>(descriptors.size()) > max_descriptors)
+        {
+            throw std::out_of_range("Too many descriptors for a single message.");
         }
 
-        auto addr = ep.serialize();
-        auto n = sendto(socket_, reinterpret_cast<const char*>(buffer.data()), static_cast<int>(buffer.size()),
-                        static_cast<std::underlying_type_t<socket_flags>>(flags),
-                        reinterpret_cast<const sockaddr*>(addr.data()), static_cast<int>(addr.size()));
-        validate_transfer(n, "sendto");
+#ifdef _WIN32
+        throw std::runtime_error("Passing descriptors isn't supported on this platform.");
+#else
+        iovec b = {const_cast<uint8_t*>(data.data()), static_cast<size_t>(data.size())};
+        std::array<char, CMSG_SPACE(sizeof(int) * max_descriptors)> control = {0};
+        msghdr message = {0};
+        message.msg_iov = &b;
+        message.msg_iovlen = 1;
+
+        if (!descriptors.empty())
+        {
+            auto length = sizeof(int) * static_cast<size_t>(descriptors.size());
+            message.msg_control = control.data();
+            message.msg_controllen = CMSG_SPACE(length);
+
+            auto cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(length);
+            memcpy(CMSG_DATA(cmsg), descriptors.data(), length);
+        }
+
+        auto n = sendmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags) | MSG_NOSIGNAL);
+        validate_transfer(n, "sendmsg");
         return static_cast<size_t>(n);
+#endif
     }
 
-    std::future<size_t> socket::send_to_async(gsl::span<const uint8_t> buffer, const endpoint& ep, socket_flags flags) const
+    size_t socket::receive_descriptors(gsl::span<uint8_t> buffer, std::vector<native_handle_type>& descriptors,
+                                       socket_flags flags) const
     {
         validate_native_handle(socket_);
-        return detail::io_task::run<size_t>([=] {
-            return poll(0us, select_mode::write) ? std::make_tuple(true, send_to(buffer, ep, flags))
-                                                 : std::make_tuple(false, static_cast<size_t>(0));
-        });
+
+        if (buffer.data() == nullptr)
+        {
+            throw std::invalid_argument("Receive buffer is null.");
+        }
+
+#ifdef _WIN32
+        throw std::runtime_error("Passing descriptors isn't supported on this platform.");
+#else
+        iovec b = {buffer.data(), static_cast<size_t>(buffer.size())};
+        std::array<char, CMSG_SPACE(sizeof(int) * max_descriptors)> control = {0};
+        msghdr message = {0};
+        message.msg_iov = &b;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        auto n =
+            recvmsg(socket_, &message, static_cast<std::underlying_type_t<socket_flags>>(flags) | MSG_CMSG_CLOEXEC);
+        validate_transfer(n, "recvmsg");
+        descriptors.clear();
+
+        for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                auto offset = descriptors.size();
+                descriptors.resize(offset + count);
+                memcpy(descriptors.data() + offset, CMSG_DATA(cmsg), count * sizeof(int));
+            }
+        }
+
+        if ((message.msg_flags & MSG_CTRUNC) != 0)
+        {
+            // The kernel already closed the descriptors that didn't fit, the rest would be an incomplete set.
+            for (auto d : descriptors)
+            {
+                ::close(d);
+            }
+
+            descriptors.clear();
+            throw std::runtime_error("Received descriptors were truncated.");
+        }
+
+        return static_cast<size_t>(n);
+#endif
     }
 
     void socket::shutdown(socket_shutdown flags) const
@@ -749,56 +2554,49 @@ namespace exa
     void socket::select(std::vector<std::shared_ptr<socket>>& read, std::vector<std::shared_ptr<socket>>& write,
                         std::vector<std::shared_ptr<socket>>& error, const std::chrono::microseconds& us)
     {
-        timeval timeout;
-        timeout.tv_sec =
-            static_cast<decltype(timeval::tv_sec)>(std::chrono::duration_cast<std::chrono::seconds>(us).count());
-        timeout.tv_usec =
-            std::clamp<decltype(timeval::tv_usec)>(static_cast<decltype(timeval::tv_usec)>(us.count()), -999999, 999999);
-
-        fd_set readset;
-        FD_ZERO(&readset);
-        fd_set writeset;
-        FD_ZERO(&writeset);
-        fd_set exceptset;
-        FD_ZERO(&exceptset);
-
-        int nfds = -1;
+#ifdef _WIN32
+        std::vector<WSAPOLLFD> descriptors;
+#else
+        std::vector<pollfd> descriptors;
+#endif
+        descriptors.reserve(read.size() + write.size() + error.size());
 
-        auto fdset = [&nfds](std::vector<std::shared_ptr<socket>>& v, fd_set& set) {
+        auto add = [&descriptors](std::vector<std::shared_ptr<socket>>& v, select_mode mode) {
             for (auto& s : v)
             {
-                FD_SET(s->socket_, &set);
-#ifndef _WIN32
-                nfds = std::max<int>(s->socket_, nfds);
-#endif
+                descriptors.push_back({s->socket_, to_poll_events(mode), 0});
             }
         };
 
-        fdset(read, readset);
-        fdset(write, writeset);
-        fdset(error, exceptset);
-        auto rc = ::select(nfds + 1, &readset, &writeset, &exceptset, &timeout);
-        validate_transfer(rc, "select");
+        add(read, select_mode::read);
+        add(write, select_mode::write);
+        add(error, select_mode::error);
 
-        auto result = [](std::vector<std::shared_ptr<socket>>& v, fd_set& set) {
-            for (auto it = std::begin(v); it != std::end(v);)
-            {
-                auto& s = *it;
+#ifdef _WIN32
+        auto rc = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), to_poll_timeout(us));
+#else
+        auto rc = ::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), to_poll_timeout(us));
+#endif
+        validate_transfer(rc, "poll");
 
-                if (FD_ISSET(s->socket_, &set))
-                {
-                    ++it;
-                }
-                else
+        auto it = std::begin(descriptors);
+        auto result = [&it](std::vector<std::shared_ptr<socket>>& v, select_mode mode) {
+            size_t n = 0;
+
+            for (size_t i = 0; i < v.size(); ++i, ++it)
+            {
+                if (is_poll_ready(mode, it->revents))
                 {
-                    it = v.erase(it);
+                    std::swap(v[n++], v[i]);
                 }
             }
+
+            v.resize(n);
         };
 
-        result(read, readset);
-        result(write, writeset);
-        result(error, exceptset);
+        result(read, select_mode::read);
+        result(write, select_mode::write);
+        result(error, select_mode::error);
     }
 
     bool socket::protocol_supported(address_family family)
@@ -864,6 +2662,83 @@ namespace exa
 #endif
     }
 
+    void socket::drain_error_queue() const
+    {
+#ifndef _WIN32
+        std::array<char, 512> control;
+        msghdr message = {0};
+
+        while (true)
+        {
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+
+            if (recvmsg(socket_, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    return;
+                }
+
+                throw_error("recvmsg");
+            }
+
+            socket_timestamp timestamp;
+            bool has_timestamp = false;
+
+            for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+#ifdef SO_TIMESTAMPING
+                if (read_timestamp(cmsg, timestamp))
+                {
+                    has_timestamp = true;
+                    continue;
+                }
+#endif
+                if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                    !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+                {
+                    continue;
+                }
+
+                sock_extended_err error;
+                memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+
+                if (error_queue_ == nullptr)
+                {
+                    continue;
+                }
+
+                if (error.ee_errno == 0 && error.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+                {
+                    // Completions are reported as inclusive id ranges which may wrap around.
+                    lock(*error_queue_, [&] {
+                        for (auto id = error.ee_info;; ++id)
+                        {
+                            error_queue_->pending_zero_copy.erase(id);
+
+                            if (id == error.ee_data)
+                            {
+                                break;
+                            }
+                        }
+                    });
+                }
+                else if (error.ee_origin == SO_EE_ORIGIN_TIMESTAMPING && has_timestamp)
+                {
+                    lock(*error_queue_, [&] {
+                        if (error_queue_->pending_timestamp == error.ee_data)
+                        {
+                            error_queue_->reported_timestamp = timestamp;
+                            error_queue_->pending_timestamp.reset();
+                        }
+                    });
+                }
+            }
+        }
+#endif
+    }
+
     void socket::validate_transfer(int rc, const std::string& message)
     {
 #ifdef _WIN32
@@ -880,11 +2755,32 @@ namespace exa
     }
 
     void socket::throw_error(const std::string& message)
+    {
+        throw std::system_error(last_error(), message);
+    }
+
+    std::error_code socket::last_error()
+    {
+#ifdef _WIN32
+        return std::error_code(WSAGetLastError(), std::system_category());
+#else
+        return std::error_code(errno, std::system_category());
+#endif
+    }
+
+    size_t socket::check_transfer(std::ptrdiff_t rc, std::error_code& ec)
     {
 #ifdef _WIN32
-        throw std::system_error(WSAGetLastError(), std::system_category(), message);
+        if (rc == SOCKET_ERROR)
 #else
-        throw std::system_error(errno, std::system_category(), message);
+        if (rc == -1)
 #endif
+        {
+            ec = last_error();
+            return 0;
+        }
+
+        ec.clear();
+        return static_cast<size_t>(rc);
     }
 }
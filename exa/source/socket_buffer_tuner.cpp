@@ -0,0 +1,250 @@
+#include <exa/socket_buffer_tuner.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace exa
+{
+    namespace
+    {
+        bool exceeds_hysteresis(size_t current, size_t target, double hysteresis)
+        {
+            auto difference = std::abs(static_cast<double>(target) - static_cast<double>(current));
+            return difference > static_cast<double>(current) * hysteresis;
+        }
+    }
+
+    socket_buffer_tuner::socket_buffer_tuner(const socket_buffer_tuner_options& options) : options_(options)
+    {
+        if (options.min_buffer == 0 || options.min_buffer > options.max_buffer)
+        {
+            throw std::out_of_range("Buffer limits need to satisfy 0 < min_buffer <= max_buffer.");
+        }
+        if (options.headroom < 1)
+        {
+            throw std::out_of_range("Headroom must be at least 1.");
+        }
+        if (options.hysteresis < 0)
+        {
+            throw std::out_of_range("Hysteresis can't be negative.");
+        }
+    }
+
+    socket_buffer_tuner::~socket_buffer_tuner()
+    {
+        stop();
+    }
+
+    const socket_buffer_tuner_options& socket_buffer_tuner::options() const
+    {
+        return options_;
+    }
+
+    size_t socket_buffer_tuner::size() const
+    {
+        size_t n = 0;
+        lock(connections_, [&] { n = connections_.size(); });
+        return n;
+    }
+
+    size_t socket_buffer_tuner::memory() const
+    {
+        size_t n = 0;
+        lock(connections_, [&] {
+            for (auto& c : connections_)
+            {
+                n += c.send_buffer + c.receive_buffer;
+            }
+        });
+        return n;
+    }
+
+    bool socket_buffer_tuner::running() const
+    {
+        return worker_.running();
+    }
+
+    void socket_buffer_tuner::add(const std::shared_ptr<socket>& s)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't tune nullptr socket.");
+        }
+        if (s->protocol() != protocol_type::tcp)
+        {
+            throw std::invalid_argument("Only TCP sockets can be tuned.");
+        }
+
+        auto info = s->tcp_info();
+
+        connection c;
+        c.socket = s;
+        c.time = std::chrono::steady_clock::now();
+        c.bytes_acked = info.bytes_acked;
+        c.bytes_received = info.bytes_received;
+
+        if (s->connected())
+        {
+            // Shrinking the buffers of a busy connection would stall it until the next measurement.
+            c.send_buffer = s->send_buffer();
+            c.receive_buffer = s->receive_buffer();
+        }
+        else
+        {
+            s->send_buffer(options_.min_buffer);
+            s->receive_buffer(options_.min_buffer);
+            c.send_buffer = options_.min_buffer;
+            c.receive_buffer = options_.min_buffer;
+        }
+
+        lock(connections_, [&] { connections_.push_back(c); });
+    }
+
+    void socket_buffer_tuner::add(const std::shared_ptr<tcp_client>& c)
+    {
+        if (c == nullptr)
+        {
+            throw std::invalid_argument("Can't tune nullptr client.");
+        }
+
+        add(c->socket());
+    }
+
+    void socket_buffer_tuner::remove(const std::shared_ptr<socket>& s)
+    {
+        lock(connections_, [&] {
+            connections_.erase(std::remove_if(std::begin(connections_), std::end(connections_),
+                                              [&](auto&& c) { return c.socket.lock() == s; }),
+                               std::end(connections_));
+        });
+    }
+
+    size_t socket_buffer_tuner::tune()
+    {
+        auto now = std::chrono::steady_clock::now();
+        size_t resized = 0;
+
+        lock(connections_, [&] {
+            // Kept in the same order as the remaining connections, the last owner may drop a socket at any time.
+            std::vector<std::shared_ptr<socket>> live;
+            auto end = std::remove_if(std::begin(connections_), std::end(connections_), [&](auto&& c) {
+                auto s = c.socket.lock();
+
+                if (s == nullptr || !s->valid())
+                {
+                    return true;
+                }
+
+                live.push_back(std::move(s));
+                return false;
+            });
+            connections_.erase(end, std::end(connections_));
+
+            auto min = static_cast<double>(options_.min_buffer);
+            auto max = static_cast<double>(options_.max_buffer);
+            std::vector<std::pair<double, double>> targets;
+            double extra = 0;
+
+            for (size_t i = 0; i < connections_.size(); ++i)
+            {
+                auto& c = connections_[i];
+                auto send = static_cast<double>(c.send_buffer);
+                auto receive = static_cast<double>(c.receive_buffer);
+                auto seconds = std::chrono::duration<double>(now - c.time).count();
+
+                try
+                {
+                    auto info = live[i]->tcp_info();
+
+                    if (seconds > 0)
+                    {
+                        auto rtt = std::chrono::duration<double>(std::max(info.rtt, info.min_rtt)).count();
+                        auto send_rate = std::max(static_cast<double>(info.bytes_acked - c.bytes_acked) / seconds,
+                                                  static_cast<double>(info.delivery_rate));
+                        auto receive_rate = static_cast<double>(info.bytes_received - c.bytes_received) / seconds;
+                        send = send_rate * rtt * options_.headroom;
+                        receive = receive_rate * rtt * options_.headroom;
+                    }
+
+                    c.time = now;
+                    c.bytes_acked = info.bytes_acked;
+                    c.bytes_received = info.bytes_received;
+                }
+                catch (const std::exception&)
+                {
+                    // The socket was closed concurrently, it gets dropped next time.
+                }
+
+                targets.emplace_back(std::clamp(send, min, max), std::clamp(receive, min, max));
+                extra += targets.back().first + targets.back().second - 2 * min;
+            }
+
+            // Every buffer keeps its minimum, the memory above it is shared proportionally.
+            auto available = static_cast<double>(options_.memory_limit) - 2 * min * connections_.size();
+            auto factor = extra > available ? std::max(available, 0.0) / extra : 1.0;
+            std::vector<std::pair<size_t, size_t>> sizes;
+            size_t kept = 0;
+
+            for (size_t i = 0; i < connections_.size(); ++i)
+            {
+                auto& c = connections_[i];
+                auto send = static_cast<size_t>(min + (targets[i].first - min) * factor);
+                auto receive = static_cast<size_t>(min + (targets[i].second - min) * factor);
+                sizes.emplace_back(send, receive);
+                kept += exceeds_hysteresis(c.send_buffer, send, options_.hysteresis) ? send : c.send_buffer;
+                kept += exceeds_hysteresis(c.receive_buffer, receive, options_.hysteresis) ? receive : c.receive_buffer;
+            }
+
+            // Hysteresis only applies as long as the kept buffers fit into the memory limit.
+            auto force = kept > options_.memory_limit;
+
+            for (size_t i = 0; i < connections_.size(); ++i)
+            {
+                auto& c = connections_[i];
+                auto& s = live[i];
+                auto [send, receive] = sizes[i];
+                auto changed = false;
+
+                try
+                {
+                    if (send != c.send_buffer && (force || exceeds_hysteresis(c.send_buffer, send, options_.hysteresis)))
+                    {
+                        s->send_buffer(send);
+                        c.send_buffer = send;
+                        changed = true;
+                    }
+                    if (receive != c.receive_buffer &&
+                        (force || exceeds_hysteresis(c.receive_buffer, receive, options_.hysteresis)))
+                    {
+                        s->receive_buffer(receive);
+                        c.receive_buffer = receive;
+                        changed = true;
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    // Same as above, the connection is gone.
+                }
+
+                resized += changed ? 1 : 0;
+            }
+        });
+
+        return resized;
+    }
+
+    void socket_buffer_tuner::start(const std::chrono::milliseconds& interval)
+    {
+        if (interval.count() <= 0)
+        {
+            throw std::out_of_range("Tuning interval must be greater than 0.");
+        }
+
+        worker_.start(interval, [this] { tune(); });
+    }
+
+    void socket_buffer_tuner::stop()
+    {
+        worker_.stop();
+    }
+}
@@ -1,5 +1,6 @@
 #include <exa/stream.hpp>
 #include <exa/task.hpp>
+#include <exa/detail/kernel_copy.hpp>
 
 #include <functional>
 #include <vector>
@@ -80,6 +81,11 @@ namespace exa
             throw std::out_of_range("Can't copy to a stream with buffer size lower than or equal to 0.");
         }
 
+        if (detail::kernel_copy::run(*this, *s, buffer_size))
+        {
+            return;
+        }
+
         std::vector<uint8_t> v(static_cast<size_t>(buffer_size));
         auto r = read(v);
 
@@ -89,7 +89,7 @@ namespace exa
 
             scope(std::unique_lock(task_queue_), [&](auto&& lock) {
                 waiting_ += 1;
-                task_signal_.wait(lock);
+                task_signal_.wait(lock, [this] { return !run_ || !task_queue_.empty(); });
                 waiting_ -= 1;
 
                 if (!run_)
@@ -18,6 +18,14 @@ namespace exa
 
     tcp_client::tcp_client(const endpoint& local_ep) : tcp_client(local_ep.family())
     {
+#ifdef IP_BIND_ADDRESS_NO_PORT
+        if (local_ep.port() == 0)
+        {
+            // Otherwise bind reserves a port for every destination.
+            socket_->bind_address_no_port(true);
+        }
+#endif
+
         socket_->bind(local_ep);
     }
 
@@ -150,6 +158,17 @@ namespace exa
         socket_->linger_state(value);
     }
 
+    bool tcp_client::abortive_close() const
+    {
+        auto l = socket_->linger_state();
+        return l.enabled && l.linger_time.count() == 0;
+    }
+
+    void tcp_client::abortive_close(bool value)
+    {
+        socket_->linger_state(linger_option{value, std::chrono::seconds(0)});
+    }
+
     bool tcp_client::no_delay() const
     {
         return socket_->no_delay();
@@ -200,6 +219,11 @@ namespace exa
         socket_->receive_timeout(value);
     }
 
+    socket_tcp_info tcp_client::tcp_info() const
+    {
+        return socket_->tcp_info();
+    }
+
     const std::shared_ptr<socket>& tcp_client::socket() const
     {
         return socket_;
@@ -220,6 +244,16 @@ namespace exa
         return socket_->connect_async(ep);
     }
 
+    size_t tcp_client::connect(const endpoint& remote_ep, gsl::span<const uint8_t> data)
+    {
+        return socket_->connect(remote_ep, data);
+    }
+
+    std::future<size_t> tcp_client::connect_async(const endpoint& remote_ep, gsl::span<const uint8_t> data)
+    {
+        return socket_->connect_async(remote_ep, data);
+    }
+
     void tcp_client::connect(const address& addr, uint16_t port)
     {
         socket_->connect(addr, port);
@@ -0,0 +1,410 @@
+#include <exa/tcp_client_pool.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    namespace
+    {
+        using pool_key = std::vector<uint8_t>;
+
+        bool alive(const std::shared_ptr<tcp_client>& c)
+        {
+            if (!c->connected() || !c->socket()->valid())
+            {
+                return false;
+            }
+
+            // Nothing should arrive on an idle connection, readable means the peer closed it or sent data
+            // nobody is going to read.
+            return !c->stream()->data_available() && !c->socket()->poll(0us, select_mode::read);
+        }
+    }
+
+    struct tcp_client_pool::pool_state
+    {
+        struct idle_client
+        {
+            std::shared_ptr<tcp_client> client;
+            std::chrono::steady_clock::time_point since;
+        };
+
+        struct entry
+        {
+            endpoint ep;
+            // Oldest first, acquire takes the most recently used connection.
+            std::deque<idle_client> idle;
+            size_t leased = 0;
+            size_t connecting = 0;
+            std::deque<uint64_t> waiters;
+
+            size_t total() const
+            {
+                return idle.size() + leased + connecting;
+            }
+        };
+
+        tcp_client_pool_options options;
+        mutable std::mutex mutex;
+        std::condition_variable available;
+        std::map<pool_key, entry> entries;
+        uint64_t next_ticket = 0;
+
+        entry& find(const endpoint& ep)
+        {
+            auto it = entries.find(ep.serialize());
+
+            if (it == std::end(entries))
+            {
+                it = entries.emplace(ep.serialize(), entry()).first;
+                it->second.ep = ep;
+            }
+
+            return it->second;
+        }
+
+        bool can_connect(const entry& e) const
+        {
+            return options.max_connections == 0 || e.total() < options.max_connections;
+        }
+
+        std::shared_ptr<tcp_client> connect(const endpoint& ep) const
+        {
+            auto c = std::make_shared<tcp_client>(ep.family());
+
+            if (options.local_port_range.low != 0 || options.local_port_range.high != 0)
+            {
+                c->socket()->local_port_range(options.local_port_range);
+            }
+            if (options.abortive_close)
+            {
+                c->abortive_close(true);
+            }
+
+            c->connect(ep);
+            return c;
+        }
+
+        static std::shared_ptr<tcp_client> lease(const std::shared_ptr<pool_state>& state, entry& e,
+                                                 const std::shared_ptr<tcp_client>& c)
+        {
+            auto key = e.ep.serialize();
+            std::weak_ptr<pool_state> weak = state;
+
+            return std::shared_ptr<tcp_client>(c.get(), [weak, key, c](tcp_client*) {
+                if (auto s = weak.lock())
+                {
+                    s->give_back(key, c);
+                }
+            });
+        }
+
+        void give_back(const pool_key& key, const std::shared_ptr<tcp_client>& c)
+        {
+            auto reusable = alive(c);
+            auto kept = false;
+
+            lock(mutex, [&] {
+                auto& e = entries.at(key);
+                e.leased -= 1;
+
+                if (reusable && e.idle.size() < options.max_idle)
+                {
+                    e.idle.push_back(idle_client{c, std::chrono::steady_clock::now()});
+                    kept = true;
+                }
+            });
+
+            available.notify_all();
+
+            if (!kept)
+            {
+                c->close();
+            }
+        }
+    };
+
+    tcp_client_pool::tcp_client_pool(const tcp_client_pool_options& options) : state_(std::make_shared<pool_state>())
+    {
+        if (options.max_idle < options.min_idle)
+        {
+            throw std::out_of_range("Maximum idle connections can't be less than minimum idle connections.");
+        }
+        if (options.max_connections != 0 && options.max_connections < options.min_idle)
+        {
+            throw std::out_of_range("Maximum connections can't be less than minimum idle connections.");
+        }
+        if (options.idle_timeout.count() <= 0)
+        {
+            throw std::out_of_range("Idle timeout must be greater than 0.");
+        }
+
+        state_->options = options;
+    }
+
+    tcp_client_pool::~tcp_client_pool()
+    {
+        stop();
+    }
+
+    const tcp_client_pool_options& tcp_client_pool::options() const
+    {
+        return state_->options;
+    }
+
+    size_t tcp_client_pool::idle(const endpoint& ep) const
+    {
+        size_t n = 0;
+
+        lock(state_->mutex, [&] {
+            auto it = state_->entries.find(ep.serialize());
+            n = it != std::end(state_->entries) ? it->second.idle.size() : 0;
+        });
+
+        return n;
+    }
+
+    size_t tcp_client_pool::leased(const endpoint& ep) const
+    {
+        size_t n = 0;
+
+        lock(state_->mutex, [&] {
+            auto it = state_->entries.find(ep.serialize());
+            n = it != std::end(state_->entries) ? it->second.leased : 0;
+        });
+
+        return n;
+    }
+
+    bool tcp_client_pool::running() const
+    {
+        return worker_.running();
+    }
+
+    std::shared_ptr<tcp_client> tcp_client_pool::acquire(const endpoint& ep)
+    {
+        return acquire(ep, std::chrono::milliseconds::max());
+    }
+
+    std::shared_ptr<tcp_client> tcp_client_pool::acquire(const endpoint& ep, const std::chrono::milliseconds& timeout)
+    {
+        auto& s = *state_;
+        std::unique_lock<std::mutex> l(s.mutex);
+        auto& e = s.find(ep);
+        auto ticket = s.next_ticket++;
+        e.waiters.push_back(ticket);
+
+        auto ready = [&] { return e.waiters.front() == ticket && (!e.idle.empty() || s.can_connect(e)); };
+        auto satisfied = true;
+
+        if (timeout == std::chrono::milliseconds::max())
+        {
+            s.available.wait(l, ready);
+        }
+        else
+        {
+            satisfied = s.available.wait_for(l, timeout, ready);
+        }
+
+        e.waiters.erase(std::find(std::begin(e.waiters), std::end(e.waiters), ticket));
+        s.available.notify_all();
+
+        if (!satisfied)
+        {
+            throw std::runtime_error("Timed out waiting for a pooled connection.");
+        }
+
+        while (!e.idle.empty())
+        {
+            auto c = std::move(e.idle.back().client);
+            e.idle.pop_back();
+
+            if (alive(c))
+            {
+                e.leased += 1;
+                return pool_state::lease(state_, e, c);
+            }
+
+            c->close();
+        }
+
+        e.connecting += 1;
+        l.unlock();
+
+        try
+        {
+            auto c = s.connect(ep);
+            l.lock();
+            e.connecting -= 1;
+            e.leased += 1;
+            return pool_state::lease(state_, e, c);
+        }
+        catch (...)
+        {
+            if (!l.owns_lock())
+            {
+                l.lock();
+            }
+
+            e.connecting -= 1;
+            s.available.notify_all();
+            throw;
+        }
+    }
+
+    size_t tcp_client_pool::warm(const endpoint& ep)
+    {
+        auto& s = *state_;
+        size_t needed = 0;
+        pool_state::entry* e = nullptr;
+
+        lock(s.mutex, [&] {
+            e = &s.find(ep);
+
+            while (e->idle.size() + e->connecting + needed < s.options.min_idle &&
+                   (s.options.max_connections == 0 || e->total() + needed < s.options.max_connections))
+            {
+                needed += 1;
+            }
+
+            e->connecting += needed;
+        });
+
+        size_t created = 0;
+
+        try
+        {
+            for (; created < needed; ++created)
+            {
+                auto c = s.connect(ep);
+                lock(s.mutex, [&] {
+                    e->connecting -= 1;
+                    e->idle.push_back(pool_state::idle_client{c, std::chrono::steady_clock::now()});
+                });
+                s.available.notify_all();
+            }
+        }
+        catch (...)
+        {
+            lock(s.mutex, [&] { e->connecting -= needed - created; });
+            s.available.notify_all();
+            throw;
+        }
+
+        return created;
+    }
+
+    size_t tcp_client_pool::evict()
+    {
+        auto& s = *state_;
+        std::vector<std::shared_ptr<tcp_client>> closing;
+        auto expired = std::chrono::steady_clock::now() - s.options.idle_timeout;
+
+        lock(s.mutex, [&] {
+            for (auto& [key, e] : s.entries)
+            {
+                std::deque<pool_state::idle_client> kept;
+
+                for (auto& i : e.idle)
+                {
+                    if (!alive(i.client))
+                    {
+                        closing.push_back(i.client);
+                    }
+                    else
+                    {
+                        kept.push_back(i);
+                    }
+                }
+
+                // Oldest connections come first, stop once the rest is young enough or only min_idle are left.
+                while (kept.size() > s.options.min_idle && kept.front().since < expired)
+                {
+                    closing.push_back(kept.front().client);
+                    kept.pop_front();
+                }
+
+                e.idle.swap(kept);
+            }
+        });
+
+        if (!closing.empty())
+        {
+            s.available.notify_all();
+        }
+
+        for (auto& c : closing)
+        {
+            c->close();
+        }
+
+        return closing.size();
+    }
+
+    void tcp_client_pool::clear()
+    {
+        std::vector<std::shared_ptr<tcp_client>> closing;
+
+        lock(state_->mutex, [&] {
+            for (auto& [key, e] : state_->entries)
+            {
+                for (auto& i : e.idle)
+                {
+                    closing.push_back(i.client);
+                }
+
+                e.idle.clear();
+            }
+        });
+
+        state_->available.notify_all();
+
+        for (auto& c : closing)
+        {
+            c->close();
+        }
+    }
+
+    void tcp_client_pool::start(const std::chrono::milliseconds& interval)
+    {
+        if (interval.count() <= 0)
+        {
+            throw std::out_of_range("Maintenance interval must be greater than 0.");
+        }
+
+        worker_.start(interval, [this] {
+            evict();
+
+            std::vector<endpoint> endpoints;
+            lock(state_->mutex, [&] {
+                for (auto& [key, e] : state_->entries)
+                {
+                    endpoints.push_back(e.ep);
+                }
+            });
+
+            for (auto& ep : endpoints)
+            {
+                try
+                {
+                    warm(ep);
+                }
+                catch (const std::system_error&)
+                {
+                    // The endpoint might be back on the next round.
+                }
+            }
+        });
+    }
+
+    void tcp_client_pool::stop()
+    {
+        worker_.stop();
+    }
+}
@@ -0,0 +1,216 @@
+#include <exa/tcp_info_sampler.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace exa
+{
+    namespace
+    {
+        size_t bucket_of(uint64_t value)
+        {
+            size_t bucket = 0;
+
+            while (value != 0)
+            {
+                value >>= 1;
+                ++bucket;
+            }
+
+            return bucket;
+        }
+    }
+
+    void tcp_info_histogram::add(uint64_t value)
+    {
+        buckets_[bucket_of(value)] += 1;
+        min_ = count_ == 0 ? value : std::min(min_, value);
+        max_ = count_ == 0 ? value : std::max(max_, value);
+        sum_ += static_cast<double>(value);
+        count_ += 1;
+    }
+
+    void tcp_info_histogram::clear()
+    {
+        *this = tcp_info_histogram();
+    }
+
+    uint64_t tcp_info_histogram::count() const
+    {
+        return count_;
+    }
+
+    uint64_t tcp_info_histogram::min() const
+    {
+        return min_;
+    }
+
+    uint64_t tcp_info_histogram::max() const
+    {
+        return max_;
+    }
+
+    double tcp_info_histogram::mean() const
+    {
+        return count_ == 0 ? 0 : sum_ / static_cast<double>(count_);
+    }
+
+    uint64_t tcp_info_histogram::percentile(double fraction) const
+    {
+        if (fraction < 0 || fraction > 1)
+        {
+            throw std::out_of_range("Percentile fraction needs to be within [0, 1].");
+        }
+        if (count_ == 0)
+        {
+            return 0;
+        }
+
+        auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(count_) + 0.5));
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets_[i];
+
+            if (seen >= rank)
+            {
+                auto upper = i == 0 ? 0 : i == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << i) - 1;
+                return std::min(upper, max_);
+            }
+        }
+
+        return max_;
+    }
+
+    const std::array<uint64_t, tcp_info_histogram::bucket_count>& tcp_info_histogram::buckets() const
+    {
+        return buckets_;
+    }
+
+    tcp_info_sampler::~tcp_info_sampler()
+    {
+        stop();
+    }
+
+    size_t tcp_info_sampler::size() const
+    {
+        size_t n = 0;
+        lock(connections_, [&] { n = connections_.size(); });
+        return n;
+    }
+
+    bool tcp_info_sampler::running() const
+    {
+        return worker_.running();
+    }
+
+    void tcp_info_sampler::add(const std::shared_ptr<socket>& s)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Can't sample nullptr socket.");
+        }
+        if (s->protocol() != protocol_type::tcp)
+        {
+            throw std::invalid_argument("Only TCP sockets can be sampled.");
+        }
+
+        lock(connections_, [&] { connections_.push_back(s); });
+    }
+
+    void tcp_info_sampler::add(const std::shared_ptr<tcp_client>& c)
+    {
+        if (c == nullptr)
+        {
+            throw std::invalid_argument("Can't sample nullptr client.");
+        }
+
+        add(c->socket());
+    }
+
+    void tcp_info_sampler::remove(const std::shared_ptr<socket>& s)
+    {
+        lock(connections_, [&] {
+            connections_.erase(std::remove_if(std::begin(connections_), std::end(connections_),
+                                              [&](auto&& c) { return c.lock() == s; }),
+                               std::end(connections_));
+        });
+    }
+
+    size_t tcp_info_sampler::sample()
+    {
+        std::vector<std::shared_ptr<socket>> live;
+
+        lock(connections_, [&] {
+            auto end = std::remove_if(std::begin(connections_), std::end(connections_), [&](auto&& c) {
+                auto s = c.lock();
+
+                if (s == nullptr || !s->valid())
+                {
+                    return true;
+                }
+
+                live.push_back(std::move(s));
+                return false;
+            });
+            connections_.erase(end, std::end(connections_));
+        });
+
+        std::vector<socket_tcp_info> infos;
+        infos.reserve(live.size());
+
+        for (auto& s : live)
+        {
+            try
+            {
+                infos.push_back(s->tcp_info());
+            }
+            catch (const std::exception&)
+            {
+                // The socket was closed concurrently, it gets dropped next time.
+            }
+        }
+
+        lock(statistics_, [&] {
+            for (auto& info : infos)
+            {
+                statistics_.samples += 1;
+                statistics_.rtt.add(static_cast<uint64_t>(info.rtt.count()));
+                statistics_.retransmits.add(info.retransmits);
+                statistics_.congestion_window.add(info.congestion_window);
+                statistics_.pacing_rate.add(info.pacing_rate);
+                statistics_.bytes_in_flight.add(info.bytes_in_flight);
+            }
+        });
+
+        return infos.size();
+    }
+
+    tcp_info_statistics tcp_info_sampler::statistics() const
+    {
+        tcp_info_statistics result;
+        lock(statistics_, [&] { result = statistics_; });
+        return result;
+    }
+
+    void tcp_info_sampler::clear()
+    {
+        lock(statistics_, [&] { static_cast<tcp_info_statistics&>(statistics_) = tcp_info_statistics(); });
+    }
+
+    void tcp_info_sampler::start(const std::chrono::milliseconds& interval)
+    {
+        if (interval.count() <= 0)
+        {
+            throw std::out_of_range("Sampling interval must be greater than 0.");
+        }
+
+        worker_.start(interval, [this] { sample(); });
+    }
+
+    void tcp_info_sampler::stop()
+    {
+        worker_.stop();
+    }
+}
@@ -1,13 +1,138 @@
 #include <exa/tcp_listener.hpp>
+#include <exa/unix_client.hpp>
 #include <exa/task.hpp>
 #include <exa/detail/io_task.hpp>
 
 #include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 using namespace std::chrono_literals;
 
 namespace exa
 {
+    namespace
+    {
+        // Sent along with the descriptor, unix sockets can't pass descriptors without data.
+        constexpr uint8_t hand_off_marker = 'L';
+        // Latency reports older than this no longer shed load, otherwise a paused listener could never recover.
+        constexpr auto latency_expiry = 1s;
+
+        uint64_t read_listen_overflows()
+        {
+#ifdef _WIN32
+            return 0;
+#else
+            std::ifstream netstat("/proc/net/netstat");
+            std::string names;
+            std::string values;
+
+            while (std::getline(netstat, names) && std::getline(netstat, values))
+            {
+                if (names.compare(0, 7, "TcpExt:") != 0)
+                {
+                    continue;
+                }
+
+                std::istringstream n(names);
+                std::istringstream v(values);
+                std::string name;
+                std::string value;
+
+                while (n >> name && v >> value)
+                {
+                    if (name == "ListenOverflows")
+                    {
+                        return std::stoull(value);
+                    }
+                }
+            }
+
+            return 0;
+#endif
+        }
+    }
+
+    struct tcp_listener::admission_state : public lockable<std::mutex>
+    {
+        tcp_admission_options options;
+        std::atomic_size_t live{0};
+        double tokens = 0;
+        std::chrono::steady_clock::time_point refilled = std::chrono::steady_clock::now();
+        std::chrono::microseconds latency{0};
+        std::chrono::steady_clock::time_point reported;
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+        uint64_t deferred = 0;
+        // Signalled when a live connection closed, the options changed or latency got reported.
+        std::condition_variable changed;
+
+        // Callers hold the lock.
+        size_t allowance(size_t max_count)
+        {
+            auto now = std::chrono::steady_clock::now();
+            auto n = max_count;
+
+            if (options.max_live_connections > 0)
+            {
+                auto current = live.load();
+                n = std::min(n, current < options.max_live_connections ? options.max_live_connections - current : 0);
+            }
+            if (options.max_accept_rate > 0)
+            {
+                auto elapsed = std::chrono::duration<double>(now - refilled).count();
+                tokens = std::min(static_cast<double>(options.accept_burst), tokens + elapsed * options.max_accept_rate);
+                refilled = now;
+                n = std::min(n, static_cast<size_t>(tokens));
+            }
+            if (options.latency_target.count() > 0 && latency > options.latency_target && now - reported < latency_expiry)
+            {
+                n = 0;
+            }
+
+            return n;
+        }
+
+        // Callers hold the lock after calling allowance. Returns max if only a closing connection can make room.
+        std::chrono::steady_clock::duration resume_delay() const
+        {
+            auto now = std::chrono::steady_clock::now();
+            auto delay = std::chrono::steady_clock::duration::zero();
+
+            if (options.max_live_connections > 0 && live >= options.max_live_connections)
+            {
+                return std::chrono::steady_clock::duration::max();
+            }
+            if (options.max_accept_rate > 0 && tokens < 1)
+            {
+                delay = std::chrono::ceil<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>((1 - tokens) / options.max_accept_rate));
+            }
+            if (options.latency_target.count() > 0 && latency > options.latency_target && now - reported < latency_expiry)
+            {
+                delay = std::max(delay, std::chrono::steady_clock::duration(reported + latency_expiry - now));
+            }
+
+            return delay;
+        }
+
+        // Callers hold the lock.
+        bool paused(bool& deferred)
+        {
+            auto paused = options.shed_mode == tcp_shed_mode::pause && allowance(1) == 0;
+
+            if (paused && !deferred)
+            {
+                this->deferred += 1;
+                deferred = true;
+            }
+
+            return paused;
+        }
+    };
+
     tcp_listener::tcp_listener(uint16_t port) : tcp_listener(endpoint(address::any, port))
     {
     }
@@ -16,11 +141,33 @@ namespace exa
     {
     }
 
-    tcp_listener::tcp_listener(const endpoint& ep) : endpoint_(ep)
+    tcp_listener::tcp_listener(const endpoint& ep) : endpoint_(ep), admission_(std::make_shared<admission_state>())
     {
         socket_ = std::make_shared<exa::socket>(ep.family(), socket_type::stream, protocol_type::tcp);
     }
 
+    tcp_listener::tcp_listener(const std::shared_ptr<exa::socket>& s) : admission_(std::make_shared<admission_state>())
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Socket for TCP listener is nullptr.");
+        }
+        if (s->type() != socket_type::stream || s->protocol() != protocol_type::tcp)
+        {
+            throw std::invalid_argument("TCP listener works only for TCP stream sockets.");
+        }
+        if (!s->listening())
+        {
+            throw std::invalid_argument("Socket for TCP listener isn't listening.");
+        }
+
+        endpoint_ = s->local_endpoint();
+        socket_ = s;
+        fast_open_ = s->fast_open();
+        defer_accept_ = s->defer_accept();
+        active_ = true;
+    }
+
     tcp_listener::~tcp_listener()
     {
         stop();
@@ -61,6 +208,55 @@ namespace exa
         socket_->reuse_address(value);
     }
 
+    bool tcp_listener::reuse_port() const
+    {
+        return socket_->reuse_port();
+    }
+
+    void tcp_listener::reuse_port(bool value)
+    {
+        if (active_)
+        {
+            throw std::runtime_error("Can't change port reusing while listening.");
+        }
+
+        socket_->reuse_port(value);
+    }
+
+    size_t tcp_listener::fast_open() const
+    {
+        return fast_open_;
+    }
+
+    void tcp_listener::fast_open(size_t queue_length)
+    {
+        if (active_)
+        {
+            socket_->fast_open(queue_length);
+        }
+
+        fast_open_ = queue_length;
+    }
+
+    std::chrono::seconds tcp_listener::defer_accept() const
+    {
+        return defer_accept_;
+    }
+
+    void tcp_listener::defer_accept(const std::chrono::seconds& timeout)
+    {
+        if (timeout.count() < 0)
+        {
+            throw std::out_of_range("Defer accept timeout can't be negative.");
+        }
+        if (active_)
+        {
+            socket_->defer_accept(timeout);
+        }
+
+        defer_accept_ = timeout;
+    }
+
     endpoint tcp_listener::local_endpoint() const
     {
         if (socket_->bound())
@@ -78,6 +274,72 @@ namespace exa
         return socket_;
     }
 
+    tcp_admission_options tcp_listener::admission() const
+    {
+        tcp_admission_options options;
+        lock(*admission_, [&] { options = admission_->options; });
+        return options;
+    }
+
+    void tcp_listener::admission(const tcp_admission_options& options)
+    {
+        if (options.max_accept_rate < 0)
+        {
+            throw std::out_of_range("Accept rate can't be negative.");
+        }
+        if (options.max_accept_rate > 0 && options.accept_burst == 0)
+        {
+            throw std::out_of_range("Accept burst must be greater than 0 when limiting the accept rate.");
+        }
+
+        lock(*admission_, [&] {
+            admission_->options = options;
+            admission_->tokens = static_cast<double>(options.accept_burst);
+            admission_->refilled = std::chrono::steady_clock::now();
+        });
+        admission_->changed.notify_all();
+    }
+
+    tcp_admission_counters tcp_listener::counters() const
+    {
+        tcp_admission_counters counters;
+
+        lock(*admission_, [&] {
+            counters.live = admission_->live;
+            counters.accepted = admission_->accepted;
+            counters.rejected = admission_->rejected;
+            counters.deferred = admission_->deferred;
+        });
+
+        counters.backlog_overflows = read_listen_overflows();
+        return counters;
+    }
+
+    void tcp_listener::report_latency(const std::chrono::microseconds& latency)
+    {
+        lock(*admission_, [&] {
+            // Smooth over single slow requests.
+            auto& a = *admission_;
+            a.latency = a.latency.count() == 0 ? latency : (a.latency * 7 + latency) / 8;
+            a.reported = std::chrono::steady_clock::now();
+        });
+        admission_->changed.notify_all();
+    }
+
+    std::chrono::steady_clock::duration tcp_listener::admission_delay() const
+    {
+        auto delay = std::chrono::steady_clock::duration::zero();
+
+        lock(*admission_, [&] {
+            if (admission_->options.shed_mode == tcp_shed_mode::pause && admission_->allowance(1) == 0)
+            {
+                delay = admission_->resume_delay();
+            }
+        });
+
+        return delay;
+    }
+
     std::shared_ptr<exa::socket> tcp_listener::accept_socket() const
     {
         if (!active_)
@@ -85,7 +347,33 @@ namespace exa
             throw std::runtime_error("TCP listener isn't actively listening.");
         }
 
-        return socket_->accept();
+        auto deferred = false;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> l(admission_->mutex());
+
+                while (admission_->paused(deferred))
+                {
+                    auto delay = admission_->resume_delay();
+
+                    if (delay == std::chrono::steady_clock::duration::max())
+                    {
+                        admission_->changed.wait(l);
+                    }
+                    else
+                    {
+                        admission_->changed.wait_for(l, delay);
+                    }
+                }
+            }
+
+            if (auto s = admit(socket_->accept()))
+            {
+                return s;
+            }
+        }
     }
 
     std::future<std::shared_ptr<exa::socket>> tcp_listener::accept_socket_async() const
@@ -95,33 +383,199 @@ namespace exa
             throw std::runtime_error("TCP listener isn't actively listening.");
         }
 
-        return socket_->accept_async();
+        auto deferred = std::make_shared<bool>(false);
+
+        return detail::io_task::run<std::shared_ptr<exa::socket>>([=] {
+            auto s = try_accept(*deferred);
+            return std::make_tuple(s != nullptr, s);
+        });
     }
 
     std::shared_ptr<tcp_client> tcp_listener::accept_client() const
+    {
+        return std::make_shared<tcp_client>(accept_socket());
+    }
+
+    std::future<std::shared_ptr<tcp_client>> tcp_listener::accept_client_async() const
     {
         if (!active_)
         {
             throw std::runtime_error("TCP listener isn't actively listening.");
         }
 
-        return std::make_shared<tcp_client>(socket_->accept());
+        auto deferred = std::make_shared<bool>(false);
+
+        return detail::io_task::run<std::shared_ptr<tcp_client>>([=] {
+            auto s = try_accept(*deferred);
+            return s != nullptr ? std::make_tuple(true, std::make_shared<tcp_client>(s))
+                                : std::make_tuple(false, std::shared_ptr<tcp_client>());
+        });
     }
 
-    std::future<std::shared_ptr<tcp_client>> tcp_listener::accept_client_async() const
+    tcp_first_read tcp_listener::accept_client_with_data(buffer_pool& pool,
+                                                         const std::chrono::milliseconds& timeout) const
+    {
+        if (timeout.count() < 0)
+        {
+            throw std::out_of_range("First read timeout can't be negative.");
+        }
+
+        auto s = accept_socket();
+        tcp_first_read result{std::make_shared<tcp_client>(s), pool.acquire(), 0};
+
+        try
+        {
+            if (!s->poll(timeout, select_mode::read))
+            {
+                result.timed_out = true;
+                return result;
+            }
+
+            result.size = s->receive(result.buffer);
+        }
+        catch (...)
+        {
+            pool.release(std::move(result.buffer));
+            std::rethrow_exception(std::current_exception());
+        }
+
+        return result;
+    }
+
+    std::future<tcp_first_read> tcp_listener::accept_client_with_data_async(
+        buffer_pool& pool, const std::chrono::milliseconds& timeout) const
     {
         if (!active_)
         {
             throw std::runtime_error("TCP listener isn't actively listening.");
         }
+        if (timeout.count() < 0)
+        {
+            throw std::out_of_range("First read timeout can't be negative.");
+        }
 
-        return detail::io_task::run<std::shared_ptr<tcp_client>>([=] {
-            return socket_->poll(0us, select_mode::read)
-                       ? std::make_tuple(true, std::make_shared<tcp_client>(socket_->accept()))
-                       : std::make_tuple(false, std::shared_ptr<tcp_client>());
+        struct state
+        {
+            std::shared_ptr<exa::socket> socket;
+            std::chrono::steady_clock::time_point accepted;
+            bool deferred = false;
+        };
+
+        auto p = &pool;
+        auto st = std::make_shared<state>();
+
+        return detail::io_task::run<tcp_first_read>([=] {
+            if (st->socket == nullptr)
+            {
+                st->socket = try_accept(st->deferred);
+                st->accepted = std::chrono::steady_clock::now();
+            }
+            if (st->socket == nullptr)
+            {
+                return std::make_tuple(false, tcp_first_read());
+            }
+
+            auto readable = st->socket->poll(0us, select_mode::read);
+
+            if (!readable && std::chrono::steady_clock::now() - st->accepted < timeout)
+            {
+                return std::make_tuple(false, tcp_first_read());
+            }
+
+            tcp_first_read result{std::make_shared<tcp_client>(st->socket), p->acquire(), 0};
+
+            if (!readable)
+            {
+                result.timed_out = true;
+                return std::make_tuple(true, std::move(result));
+            }
+
+            try
+            {
+                result.size = st->socket->receive(result.buffer);
+            }
+            catch (...)
+            {
+                p->release(std::move(result.buffer));
+                std::rethrow_exception(std::current_exception());
+            }
+
+            return std::make_tuple(true, std::move(result));
+        });
+    }
+
+    std::vector<std::shared_ptr<tcp_client>> tcp_listener::accept_clients(size_t max_count) const
+    {
+        std::vector<std::shared_ptr<tcp_client>> clients;
+
+        for (auto& s : accept_sockets(max_count))
+        {
+            clients.push_back(std::make_shared<tcp_client>(s));
+        }
+
+        return clients;
+    }
+
+    std::future<std::vector<std::shared_ptr<tcp_client>>> tcp_listener::accept_clients_async(size_t max_count) const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("TCP listener isn't actively listening.");
+        }
+
+        auto deferred = std::make_shared<bool>(false);
+
+        return detail::io_task::run<std::vector<std::shared_ptr<tcp_client>>>([=] {
+            if (paused(*deferred) || !socket_->poll(0us, select_mode::read))
+            {
+                return std::make_tuple(false, std::vector<std::shared_ptr<tcp_client>>());
+            }
+
+            auto clients = accept_clients(max_count);
+            return std::make_tuple(!clients.empty(), clients);
         });
     }
 
+    std::vector<std::shared_ptr<exa::socket>> tcp_listener::accept_sockets(size_t max_count) const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("TCP listener isn't actively listening.");
+        }
+        if (max_count == 0)
+        {
+            throw std::out_of_range("Accept batch needs room for at least one socket.");
+        }
+
+        auto n = max_count;
+        auto pausing = false;
+        lock(*admission_, [&] { pausing = admission_->options.shed_mode == tcp_shed_mode::pause; });
+
+        if (pausing)
+        {
+            auto deferred = false;
+            n = allowance(max_count);
+
+            if (n == 0)
+            {
+                paused(deferred);
+                return {};
+            }
+        }
+
+        std::vector<std::shared_ptr<exa::socket>> sockets;
+
+        for (auto& s : socket_->accept_batch(n))
+        {
+            if (auto admitted = admit(s))
+            {
+                sockets.push_back(admitted);
+            }
+        }
+
+        return sockets;
+    }
+
     bool tcp_listener::pending() const
     {
         if (!active_)
@@ -132,6 +586,80 @@ namespace exa
         return socket_->poll(0us, select_mode::read);
     }
 
+    size_t tcp_listener::allowance(size_t max_count) const
+    {
+        size_t n = 0;
+        lock(*admission_, [&] { n = admission_->allowance(max_count); });
+        return n;
+    }
+
+    bool tcp_listener::paused(bool& deferred) const
+    {
+        auto paused = false;
+        lock(*admission_, [&] { paused = admission_->paused(deferred); });
+        return paused;
+    }
+
+    std::shared_ptr<exa::socket> tcp_listener::admit(const std::shared_ptr<exa::socket>& s) const
+    {
+        auto admitted = false;
+
+        lock(*admission_, [&] {
+            if (admission_->allowance(1) == 1)
+            {
+                admitted = true;
+                admission_->accepted += 1;
+                admission_->live += 1;
+
+                if (admission_->options.max_accept_rate > 0)
+                {
+                    admission_->tokens -= 1;
+                }
+            }
+        });
+
+        if (!admitted)
+        {
+            reject(s);
+            return nullptr;
+        }
+
+        // The live count drops once the last owner is gone, the socket itself is released right away as well.
+        auto state = admission_;
+        return std::shared_ptr<exa::socket>(s.get(), [owner = s, state](exa::socket*) mutable {
+            owner.reset();
+            // Decremented under the lock so a paused accept_socket can't miss the notification.
+            lock(*state, [&] { state->live -= 1; });
+            state->changed.notify_all();
+        });
+    }
+
+    std::shared_ptr<exa::socket> tcp_listener::try_accept(bool& deferred) const
+    {
+        if (paused(deferred) || !socket_->poll(0us, select_mode::read))
+        {
+            return nullptr;
+        }
+
+        return admit(socket_->accept());
+    }
+
+    void tcp_listener::reject(const std::shared_ptr<exa::socket>& s) const
+    {
+        try
+        {
+            // Resetting tells the client right away instead of leaving it to time out.
+            s->linger_state(linger_option{true, 0s});
+        }
+        catch (const std::system_error&)
+        {
+            // Closing still works without the reset.
+        }
+
+        s->close();
+        lock(*admission_, [&] { admission_->rejected += 1; });
+    }
+
     void tcp_listener::start(size_t backlog)
     {
         if (backlog == 0 || backlog > max_connections)
@@ -147,6 +675,15 @@ namespace exa
 
         try
         {
+            if (fast_open_ > 0)
+            {
+                socket_->fast_open(fast_open_);
+            }
+            if (defer_accept_.count() > 0)
+            {
+                socket_->defer_accept(defer_accept_);
+            }
+
             socket_->listen(backlog);
         }
         catch (...)
@@ -164,6 +701,22 @@ namespace exa
         socket_ = std::make_shared<exa::socket>(endpoint_.family(), socket_type::stream, protocol_type::tcp);
         active_ = false;
     }
+
+    void tcp_listener::hand_off(unix_client& successor)
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("TCP listener isn't actively listening.");
+        }
+
+        auto s = socket_->native_handle();
+        successor.send_descriptors(gsl::span<const exa::socket::native_handle_type>(&s, 1),
+                                   gsl::span<const uint8_t>(&hand_off_marker, 1));
+
+        // The successor holds the same socket now, closing this descriptor leaves its backlog alone.
+        stop();
+    }
+
     std::shared_ptr<tcp_listener> tcp_listener::create(uint16_t port)
     {
         if (socket::ipv6_supported())
@@ -177,4 +730,24 @@ namespace exa
             return std::make_shared<tcp_listener>(address::any, port);
         }
     }
+
+    std::shared_ptr<tcp_listener> tcp_listener::adopt(unix_client& predecessor)
+    {
+        uint8_t marker = 0;
+        std::vector<exa::socket::native_handle_type> descriptors;
+        auto n = predecessor.receive_descriptors(gsl::span<uint8_t>(&marker, 1), descriptors);
+
+        if (n == 1 && marker == hand_off_marker && descriptors.size() == 1)
+        {
+            return std::make_shared<tcp_listener>(exa::socket::adopt(descriptors[0], protocol_type::tcp));
+        }
+
+        for (auto d : descriptors)
+        {
+            // Closes whatever was received instead.
+            exa::socket(d, address_family::unspecified, socket_type::stream, protocol_type::tcp);
+        }
+
+        throw std::runtime_error("Predecessor didn't hand off a listening socket.");
+    }
 }
@@ -0,0 +1,220 @@
+#include <exa/tcp_listener_group.hpp>
+#include <exa/detail/accept_round.hpp>
+
+#include <array>
+#include <chrono>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    tcp_listener_group::tcp_listener_group(const endpoint& ep, size_t shards) : endpoint_(ep), size_(shards)
+    {
+        if (shards == 0)
+        {
+            throw std::out_of_range("Listener group needs at least one shard.");
+        }
+    }
+
+    tcp_listener_group::~tcp_listener_group()
+    {
+        stop();
+    }
+
+    bool tcp_listener_group::active() const
+    {
+        return active_;
+    }
+
+    size_t tcp_listener_group::size() const
+    {
+        return size_;
+    }
+
+    bool tcp_listener_group::cpu_steering() const
+    {
+        return cpu_steering_;
+    }
+
+    void tcp_listener_group::cpu_steering(bool value)
+    {
+        if (active_)
+        {
+            throw std::runtime_error("Can't change CPU steering while listening.");
+        }
+
+        cpu_steering_ = value;
+    }
+
+    endpoint tcp_listener_group::local_endpoint() const
+    {
+        return active_ ? shards_[0].listener->local_endpoint() : endpoint_;
+    }
+
+    const std::shared_ptr<tcp_listener>& tcp_listener_group::listener(size_t shard) const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("TCP listener group isn't actively listening.");
+        }
+        if (shard >= shards_.size())
+        {
+            throw std::out_of_range("Shard index is out of range.");
+        }
+
+        return shards_[shard].listener;
+    }
+
+    void tcp_listener_group::start(size_t backlog)
+    {
+        if (backlog == 0 || backlog > tcp_listener::max_connections)
+        {
+            throw std::out_of_range("Backlog value needs to within specified range of (0, 0x7fffffff].");
+        }
+        if (active_)
+        {
+            return;
+        }
+
+        try
+        {
+            // Shards join the reuse port group in listen order, so group index and shard index match.
+            auto ep = endpoint_;
+
+            for (size_t i = 0; i < size_; ++i)
+            {
+                shard s;
+                s.listener = std::make_shared<tcp_listener>(ep);
+                s.listener->reuse_port(true);
+                s.listener->start(backlog);
+                ep = s.listener->local_endpoint();
+                shards_.push_back(std::move(s));
+            }
+
+            if (cpu_steering_)
+            {
+                shards_[0].listener->socket()->reuse_port_cpu_steering(size_);
+            }
+        }
+        catch (...)
+        {
+            shards_.clear();
+            std::rethrow_exception(std::current_exception());
+        }
+
+        active_ = true;
+    }
+
+    void tcp_listener_group::start(const accept_handler& handler, size_t backlog)
+    {
+        start(handler, nullptr, backlog);
+    }
+
+    void tcp_listener_group::start(const accept_handler& handler, const error_handler& failed, size_t backlog)
+    {
+        if (!handler)
+        {
+            throw std::invalid_argument("Accept handler is empty.");
+        }
+        if (active_)
+        {
+            return;
+        }
+
+        start(backlog);
+        run_ = true;
+
+        for (size_t i = 0; i < shards_.size(); ++i)
+        {
+            auto& s = shards_[i];
+            s.listener->socket()->blocking(false);
+            s.poller = std::make_unique<poller>();
+            s.poller->add(s.listener->socket(), poll_events::read);
+            s.thread = std::thread([this, i, handler, failed] { run(i, handler, failed); });
+
+#ifndef _WIN32
+            if (cpu_steering_)
+            {
+                // Steering hands connections received on CPU c to shard c % size, so the shard runs on all of those.
+                // Shards beyond the CPU count get no connections and stay unpinned.
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+
+                for (size_t c = i; c < std::thread::hardware_concurrency() && c < CPU_SETSIZE; c += size_)
+                {
+                    CPU_SET(c, &cpus);
+                }
+                if (CPU_COUNT(&cpus) > 0)
+                {
+                    pthread_setaffinity_np(s.thread.native_handle(), sizeof(cpus), &cpus);
+                }
+            }
+#endif
+        }
+    }
+
+    void tcp_listener_group::stop()
+    {
+        run_ = false;
+
+        for (auto& s : shards_)
+        {
+            if (s.poller != nullptr)
+            {
+                s.poller->notify();
+            }
+        }
+
+        for (auto& s : shards_)
+        {
+            if (s.thread.joinable())
+            {
+                s.thread.join();
+            }
+
+            s.listener->stop();
+        }
+
+        shards_.clear();
+        active_ = false;
+    }
+
+    void tcp_listener_group::run(size_t index, const accept_handler& handler, const error_handler& failed)
+    {
+        auto& s = shards_[index];
+        std::array<poll_event, 1> events;
+        auto accept_failed = [&](const std::error_code& ec) {
+            if (failed)
+            {
+                failed(index, ec);
+            }
+        };
+
+        while (run_)
+        {
+            if (s.poller->wait(events, -1ms) == 0)
+            {
+                continue;
+            }
+
+            auto sockets = detail::accept_round::run(*s.listener, *s.poller, accept_failed);
+
+            for (auto& c : sockets)
+            {
+                try
+                {
+                    handler(index, std::make_shared<tcp_client>(c));
+                }
+                catch (const std::exception&)
+                {
+                    // A failing handler only loses its own client, the shard keeps accepting.
+                }
+            }
+        }
+    }
+}
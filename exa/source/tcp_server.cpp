@@ -0,0 +1,448 @@
+#include <exa/tcp_server.hpp>
+#include <exa/enum_flag.hpp>
+#include <exa/detail/accept_round.hpp>
+
+#include <array>
+#include <chrono>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    namespace
+    {
+        constexpr size_t max_events = 256;
+
+        bool would_block(const std::error_code& ec)
+        {
+            return ec == std::errc::operation_would_block || ec == std::errc::resource_unavailable_try_again;
+        }
+
+        template <class Handler, class... Args>
+        void call_handler(const Handler& handler, Args&&... args)
+        {
+            if (!handler)
+            {
+                return;
+            }
+
+            try
+            {
+                handler(std::forward<Args>(args)...);
+            }
+            catch (const std::exception&)
+            {
+                // A failing handler must not take down the I/O loop serving other connections.
+            }
+        }
+    }
+
+    struct tcp_connection::io_loop
+    {
+        struct connection_queue : public std::vector<std::shared_ptr<tcp_connection>>, public lockable<std::mutex>
+        {
+        };
+
+        exa::poller poller;
+        std::thread thread;
+        std::vector<uint8_t> buffer;
+        connection_queue added;
+        connection_queue closing;
+        // Only touched by the loop's own thread.
+        std::unordered_map<tcp_connection*, std::shared_ptr<tcp_connection>> connections;
+    };
+
+    tcp_connection::tcp_connection(const std::shared_ptr<exa::socket>& s, io_loop* loop) : socket_(s), loop_(loop)
+    {
+        try
+        {
+            remote_endpoint_ = s->remote_endpoint();
+        }
+        catch (const std::system_error&)
+        {
+            // The peer is already gone, reading reports that to the handlers.
+        }
+    }
+
+    bool tcp_connection::closed() const
+    {
+        bool closed = false;
+        exa::lock(*this, [&] { closed = closed_ || closing_; });
+        return closed;
+    }
+
+    endpoint tcp_connection::remote_endpoint() const
+    {
+        return remote_endpoint_;
+    }
+
+    const std::shared_ptr<exa::socket>& tcp_connection::socket() const
+    {
+        return socket_;
+    }
+
+    size_t tcp_connection::pending_output() const
+    {
+        size_t n = 0;
+        exa::lock(*this, [&] { n = output_.size() - output_offset_; });
+        return n;
+    }
+
+    void tcp_connection::send(gsl::span<const uint8_t> data)
+    {
+        exa::lock(*this, [&] {
+            if (closed_ || closing_)
+            {
+                throw std::runtime_error("Connection is closed.");
+            }
+
+            size_t n = 0;
+
+            if (output_offset_ == output_.size())
+            {
+                std::error_code ec;
+                n = socket_->send(data, ec, socket_flags::no_signal);
+
+                if (ec && !would_block(ec))
+                {
+                    error_ = ec;
+                    closing_ = true;
+                    exa::lock(loop_->closing, [&] { loop_->closing.push_back(shared_from_this()); });
+                    loop_->poller.notify();
+                    return;
+                }
+            }
+
+            if (n < static_cast<size_t>(data.size()))
+            {
+                auto was_empty = output_offset_ == output_.size();
+                output_.insert(std::end(output_), data.data() + n, data.data() + data.size());
+
+                if (was_empty)
+                {
+                    loop_->poller.modify(socket_, poll_events::read | poll_events::write, this);
+                }
+            }
+        });
+    }
+
+    void tcp_connection::close()
+    {
+        request_close(std::error_code());
+    }
+
+    void tcp_connection::request_close(const std::error_code& ec)
+    {
+        exa::lock(*this, [&] {
+            if (closed_ || closing_)
+            {
+                return;
+            }
+
+            error_ = ec;
+            closing_ = true;
+            exa::lock(loop_->closing, [&] { loop_->closing.push_back(shared_from_this()); });
+            loop_->poller.notify();
+        });
+    }
+
+    tcp_server::tcp_server(const endpoint& ep, const tcp_server_handlers& handlers, const tcp_server_options& options)
+        : tcp_server(std::make_shared<tcp_listener>(ep), handlers, options)
+    {
+    }
+
+    tcp_server::tcp_server(const std::shared_ptr<tcp_listener>& listener, const tcp_server_handlers& handlers,
+                           const tcp_server_options& options)
+        : handlers_(handlers), options_(options), listener_(listener)
+    {
+        if (listener == nullptr)
+        {
+            throw std::invalid_argument("Listener for TCP server is nullptr.");
+        }
+        if (options.io_loops == 0)
+        {
+            throw std::out_of_range("TCP server needs at least one I/O loop.");
+        }
+        if (options.read_buffer_size == 0)
+        {
+            throw std::out_of_range("Read buffer size must be greater than 0.");
+        }
+    }
+
+    tcp_server::~tcp_server()
+    {
+        stop();
+    }
+
+    bool tcp_server::active() const
+    {
+        return run_;
+    }
+
+    size_t tcp_server::connections() const
+    {
+        return connections_;
+    }
+
+    endpoint tcp_server::local_endpoint() const
+    {
+        return listener_->local_endpoint();
+    }
+
+    const std::shared_ptr<tcp_listener>& tcp_server::listener() const
+    {
+        return listener_;
+    }
+
+    void tcp_server::start()
+    {
+        if (run_)
+        {
+            return;
+        }
+
+        listener_->start(options_.backlog);
+        listener_->socket()->blocking(false);
+        accept_poller_ = std::make_unique<poller>();
+        accept_poller_->add(listener_->socket(), poll_events::read);
+        run_ = true;
+        accepting_ = true;
+
+        for (size_t i = 0; i < options_.io_loops; ++i)
+        {
+            loops_.push_back(std::make_unique<io_loop>());
+            loops_.back()->buffer.resize(options_.read_buffer_size);
+        }
+
+        for (auto& loop : loops_)
+        {
+            loop->thread = std::thread([this, l = loop.get()] { run(*l); });
+        }
+
+        accept_thread_ = std::thread([this] { accept_loop(); });
+    }
+
+    void tcp_server::stop()
+    {
+        if (!run_)
+        {
+            return;
+        }
+
+        run_ = false;
+        stop_accepting();
+
+        for (auto& loop : loops_)
+        {
+            loop->poller.notify();
+        }
+        for (auto& loop : loops_)
+        {
+            loop->thread.join();
+        }
+
+        loops_.clear();
+        accept_poller_.reset();
+        listener_->stop();
+    }
+
+    void tcp_server::hand_off(unix_client& successor)
+    {
+        if (!run_ || !accepting_)
+        {
+            throw std::runtime_error("TCP server isn't accepting connections.");
+        }
+
+        stop_accepting();
+        accept_poller_->remove(listener_->socket());
+        // The successor shares the descriptor and expects a plain blocking listener.
+        listener_->socket()->blocking(true);
+        listener_->hand_off(successor);
+    }
+
+    void tcp_server::stop_accepting()
+    {
+        if (accept_thread_.joinable())
+        {
+            accepting_ = false;
+            accept_poller_->notify();
+            accept_thread_.join();
+        }
+    }
+
+    void tcp_server::accept_loop()
+    {
+        std::array<poll_event, 1> events;
+
+        while (run_ && accepting_)
+        {
+            if (accept_poller_->wait(events, -1ms) == 0)
+            {
+                continue;
+            }
+
+            auto sockets = detail::accept_round::run(*listener_, *accept_poller_, handlers_.accept_failed);
+
+            for (auto& s : sockets)
+            {
+                auto& loop = *loops_[next_loop_++ % loops_.size()];
+                s->blocking(false);
+                std::shared_ptr<tcp_connection> c(new tcp_connection(s, &loop));
+                lock(loop.added, [&] { loop.added.push_back(c); });
+                loop.poller.notify();
+            }
+        }
+    }
+
+    void tcp_server::run(io_loop& loop)
+    {
+        std::vector<poll_event> events(max_events);
+
+        while (run_)
+        {
+            std::vector<std::shared_ptr<tcp_connection>> added;
+            std::vector<std::shared_ptr<tcp_connection>> closing;
+            lock(loop.added, [&] { added.swap(loop.added); });
+            lock(loop.closing, [&] { closing.swap(loop.closing); });
+
+            for (auto& c : added)
+            {
+                loop.connections.emplace(c.get(), c);
+                loop.poller.add(c->socket(), poll_events::read, c.get());
+                connections_ += 1;
+                call_handler(handlers_.connected, c);
+            }
+            for (auto& c : closing)
+            {
+                close(loop, c, c->error_);
+            }
+
+            auto n = loop.poller.wait(events, -1ms);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto it = loop.connections.find(static_cast<tcp_connection*>(events[i].user_data));
+
+                if (it == std::end(loop.connections))
+                {
+                    continue;
+                }
+
+                auto c = it->second;
+                auto e = events[i].events;
+
+                if (has_flag(e, poll_events::write))
+                {
+                    on_writable(loop, c);
+                }
+                if (has_flag(e, poll_events::read) || has_flag(e, poll_events::hang_up) ||
+                    has_flag(e, poll_events::error))
+                {
+                    on_readable(loop, c);
+                }
+            }
+        }
+
+        while (!loop.connections.empty())
+        {
+            close(loop, std::begin(loop.connections)->second, std::error_code());
+        }
+        for (auto& c : loop.added)
+        {
+            lock(*c, [&] { c->closed_ = true; });
+            c->socket()->close();
+        }
+    }
+
+    void tcp_server::on_readable(io_loop& loop, const std::shared_ptr<tcp_connection>& c)
+    {
+        if (c->closed_)
+        {
+            return;
+        }
+        if (handlers_.readable)
+        {
+            call_handler(handlers_.readable, c);
+            return;
+        }
+
+        std::error_code ec;
+        auto n = c->socket()->receive(loop.buffer, ec);
+
+        if (ec)
+        {
+            if (!would_block(ec))
+            {
+                close(loop, c, ec);
+            }
+        }
+        else if (n == 0)
+        {
+            close(loop, c, std::error_code());
+        }
+        else
+        {
+            call_handler(handlers_.received, c, gsl::span<const uint8_t>(loop.buffer.data(), static_cast<std::ptrdiff_t>(n)));
+        }
+    }
+
+    void tcp_server::on_writable(io_loop& loop, const std::shared_ptr<tcp_connection>& c)
+    {
+        std::error_code ec;
+
+        lock(*c, [&] {
+            if (c->closed_ || c->output_offset_ == c->output_.size())
+            {
+                return;
+            }
+
+            auto pending = gsl::span<const uint8_t>(c->output_.data() + c->output_offset_,
+                                                    static_cast<std::ptrdiff_t>(c->output_.size() - c->output_offset_));
+            auto n = c->socket()->send(pending, ec, socket_flags::no_signal);
+
+            if (ec)
+            {
+                return;
+            }
+
+            c->output_offset_ += n;
+
+            if (c->output_offset_ == c->output_.size())
+            {
+                c->output_.clear();
+                c->output_.shrink_to_fit();
+                c->output_offset_ = 0;
+                loop.poller.modify(c->socket(), poll_events::read, c.get());
+            }
+        });
+
+        if (ec && !would_block(ec))
+        {
+            close(loop, c, ec);
+        }
+    }
+
+    void tcp_server::close(io_loop& loop, const std::shared_ptr<tcp_connection>& c, const std::error_code& ec)
+    {
+        auto closed = false;
+
+        lock(*c, [&] {
+            closed = c->closed_;
+            c->closed_ = true;
+            c->output_.clear();
+            c->output_offset_ = 0;
+        });
+
+        if (closed)
+        {
+            return;
+        }
+
+        loop.poller.remove(c->socket());
+        c->socket()->close();
+        loop.connections.erase(c.get());
+        connections_ -= 1;
+        call_handler(handlers_.disconnected, c, ec);
+    }
+}
@@ -1,8 +1,104 @@
 #include <exa/udp_client.hpp>
 #include <exa/task.hpp>
 
+#include <algorithm>
+
 namespace exa
 {
+    bool udp_datagram::truncated() const
+    {
+        return size > static_cast<size_t>(data.size());
+    }
+
+    udp_segments::const_iterator::const_iterator(const udp_segments& segments, size_t index)
+        : segments_(&segments), index_(index)
+    {
+    }
+
+    udp_segments::const_iterator::value_type udp_segments::const_iterator::operator*() const
+    {
+        return (*segments_)[index_];
+    }
+
+    udp_segments::const_iterator& udp_segments::const_iterator::operator++()
+    {
+        ++index_;
+        return *this;
+    }
+
+    udp_segments::const_iterator udp_segments::const_iterator::operator++(int)
+    {
+        auto it = *this;
+        ++index_;
+        return it;
+    }
+
+    bool udp_segments::const_iterator::operator==(const const_iterator& other) const
+    {
+        return segments_ == other.segments_ && index_ == other.index_;
+    }
+
+    bool udp_segments::const_iterator::operator!=(const const_iterator& other) const
+    {
+        return !(*this == other);
+    }
+
+    udp_segments::udp_segments(gsl::span<const uint8_t> buffer, size_t segment_size)
+        : buffer_(buffer), segment_size_(segment_size)
+    {
+        if (segment_size_ == 0 && !buffer_.empty())
+        {
+            throw std::invalid_argument("Segment size can't be zero for a non-empty buffer.");
+        }
+    }
+
+    bool udp_segments::empty() const
+    {
+        return buffer_.empty();
+    }
+
+    size_t udp_segments::size() const
+    {
+        return empty() ? 0 : (bytes() + segment_size_ - 1) / segment_size_;
+    }
+
+    size_t udp_segments::bytes() const
+    {
+        return static_cast<size_t>(buffer_.size());
+    }
+
+    size_t udp_segments::segment_size() const
+    {
+        return segment_size_;
+    }
+
+    gsl::span<const uint8_t> udp_segments::buffer() const
+    {
+        return buffer_;
+    }
+
+    gsl::span<const uint8_t> udp_segments::operator[](size_t index) const
+    {
+        if (index >= size())
+        {
+            throw std::out_of_range("Segment index is out of range.");
+        }
+
+        auto offset = index * segment_size_;
+        return buffer_.subspan(static_cast<std::ptrdiff_t>(offset),
+                               static_cast<std::ptrdiff_t>(std::min(segment_size_, bytes() - offset)));
+    }
+
+    udp_segments::const_iterator udp_segments::begin() const
+    {
+        return const_iterator(*this, 0);
+    }
+
+    udp_segments::const_iterator udp_segments::end() const
+    {
+        return const_iterator(*this, size());
+    }
+
     udp_client::udp_client() : udp_client(address_family::inter_network)
     {
     }
@@ -200,13 +296,58 @@ namespace exa
         }
     }
 
+    std::vector<uint8_t> udp_client::receive(endpoint& ep, socket_timestamp& timestamp)
+    {
+        auto n = socket_->receive_from(buffer_, ep, timestamp);
+        auto first = std::begin(buffer_);
+        return std::vector<uint8_t>(first, std::next(first, n));
+    }
+
     std::future<udp_receive_result> udp_client::receive_async()
     {
         return task::run([this] {
             std::vector<uint8_t> b(max_udp_size);
             auto r = socket_->receive_from_async(b).get();
             b.resize(r.bytes);
-            return udp_receive_result{b, r.endpoint};
+            return udp_receive_result{b, r.endpoint, r.bytes};
+        });
+    }
+
+    udp_datagram udp_client::receive(gsl::span<uint8_t> buffer, endpoint& ep)
+    {
+        auto n = socket_->receive_from(buffer, ep, socket_flags::truncate);
+        auto received = std::min(n, static_cast<size_t>(buffer.size()));
+        return udp_datagram{buffer.first(static_cast<std::ptrdiff_t>(received)), n};
+    }
+
+    std::future<udp_receive_datagram_result> udp_client::receive_async(gsl::span<uint8_t> buffer)
+    {
+        return task::run([this, buffer] {
+            auto r = socket_->receive_from_async(buffer, socket_flags::truncate).get();
+            auto received = std::min(r.bytes, static_cast<size_t>(buffer.size()));
+            return udp_receive_datagram_result{
+                udp_datagram{buffer.first(static_cast<std::ptrdiff_t>(received)), r.bytes}, r.endpoint};
+        });
+    }
+
+    std::future<udp_receive_result> udp_client::receive_async(buffer_pool& pool)
+    {
+        return task::run([this, &pool] {
+            auto b = pool.acquire();
+            socket_receive_from_result r;
+
+            try
+            {
+                r = socket_->receive_from_async(b, socket_flags::truncate).get();
+            }
+            catch (...)
+            {
+                pool.release(std::move(b));
+                throw;
+            }
+
+            b.resize(std::min(r.bytes, b.size()));
+            return udp_receive_result{std::move(b), r.endpoint, r.bytes};
         });
     }
 
@@ -229,4 +370,81 @@ namespace exa
     {
         return socket_->send_to_async(buffer, ep);
     }
+
+    bool udp_client::timestamping() const
+    {
+        return socket_->timestamping();
+    }
+
+    void udp_client::timestamping(bool value)
+    {
+        socket_->timestamping(value);
+    }
+
+    bool udp_client::receive_offload() const
+    {
+        return socket_->receive_offload();
+    }
+
+    void udp_client::receive_offload(bool value)
+    {
+        socket_->receive_offload(value);
+    }
+
+    size_t udp_client::send_segments(gsl::span<const uint8_t> buffer, size_t segment_size)
+    {
+        return socket_->send_segments(buffer, segment_size);
+    }
+
+    std::future<size_t> udp_client::send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size)
+    {
+        return socket_->send_segments_async(buffer, segment_size);
+    }
+
+    size_t udp_client::send_segments(gsl::span<const uint8_t> buffer, size_t segment_size, const endpoint& ep)
+    {
+        return socket_->send_segments(buffer, segment_size, ep);
+    }
+
+    std::future<size_t> udp_client::send_segments_async(gsl::span<const uint8_t> buffer, size_t segment_size,
+                                                        const endpoint& ep)
+    {
+        return socket_->send_segments_async(buffer, segment_size, ep);
+    }
+
+    udp_segments udp_client::receive_segments(gsl::span<uint8_t> buffer, endpoint& ep)
+    {
+        auto r = socket_->receive_segments(buffer);
+        ep = r.endpoint;
+        return udp_segments(buffer.first(static_cast<std::ptrdiff_t>(r.bytes)), r.segment_size);
+    }
+
+    std::future<udp_receive_segments_result> udp_client::receive_segments_async(gsl::span<uint8_t> buffer)
+    {
+        return task::run([this, buffer] {
+            auto r = socket_->receive_segments_async(buffer).get();
+            return udp_receive_segments_result{
+                udp_segments(buffer.first(static_cast<std::ptrdiff_t>(r.bytes)), r.segment_size), r.endpoint};
+        });
+    }
+
+    size_t udp_client::receive_batch(gsl::span<socket_receive_message> messages)
+    {
+        return socket_->receive_batch(messages);
+    }
+
+    std::future<size_t> udp_client::receive_batch_async(gsl::span<socket_receive_message> messages)
+    {
+        return socket_->receive_batch_async(messages);
+    }
+
+    size_t udp_client::send_batch(gsl::span<const socket_send_message> messages)
+    {
+        return socket_->send_batch(messages);
+    }
+
+    std::future<size_t> udp_client::send_batch_async(gsl::span<const socket_send_message> messages)
+    {
+        return socket_->send_batch_async(messages);
+    }
 }
@@ -0,0 +1,144 @@
+#include <exa/unix_client.hpp>
+
+namespace exa
+{
+    unix_client::unix_client()
+    {
+        socket_ = std::make_shared<exa::socket>(address_family::unix_descriptor, socket_type::stream,
+                                                protocol_type::unspecified);
+    }
+
+    unix_client::unix_client(const std::shared_ptr<exa::socket>& s)
+    {
+        if (s == nullptr)
+        {
+            throw std::invalid_argument("Socket for unix client is nullptr.");
+        }
+        if (s->type() != socket_type::stream)
+        {
+            throw std::invalid_argument("Unix client works only for stream sockets.");
+        }
+        if (s->family() != address_family::unix_descriptor)
+        {
+            throw std::invalid_argument("Unix client works only with unix domain sockets.");
+        }
+
+        socket_ = s;
+    }
+
+    bool unix_client::connected() const
+    {
+        return socket_->connected();
+    }
+
+    size_t unix_client::available() const
+    {
+        return socket_->available();
+    }
+
+    size_t unix_client::send_buffer() const
+    {
+        return socket_->send_buffer();
+    }
+
+    void unix_client::send_buffer(size_t value)
+    {
+        socket_->send_buffer(value);
+    }
+
+    size_t unix_client::receive_buffer() const
+    {
+        return socket_->receive_buffer();
+    }
+
+    void unix_client::receive_buffer(size_t value)
+    {
+        socket_->receive_buffer(value);
+    }
+
+    std::chrono::milliseconds unix_client::send_timeout() const
+    {
+        return socket_->send_timeout();
+    }
+
+    void unix_client::send_timeout(const std::chrono::milliseconds& value)
+    {
+        socket_->send_timeout(value);
+    }
+
+    std::chrono::milliseconds unix_client::receive_timeout() const
+    {
+        return socket_->receive_timeout();
+    }
+
+    void unix_client::receive_timeout(const std::chrono::milliseconds& value)
+    {
+        socket_->receive_timeout(value);
+    }
+
+    const std::shared_ptr<socket>& unix_client::socket() const
+    {
+        return socket_;
+    }
+
+    void unix_client::close()
+    {
+        socket_->close();
+    }
+
+    void unix_client::connect(const endpoint& remote_ep)
+    {
+        if (remote_ep.family() != address_family::unix_descriptor)
+        {
+            throw std::invalid_argument("Unix client can only connect to unix endpoints.");
+        }
+
+        socket_->connect(remote_ep);
+    }
+
+    std::future<void> unix_client::connect_async(const endpoint& remote_ep)
+    {
+        if (remote_ep.family() != address_family::unix_descriptor)
+        {
+            throw std::invalid_argument("Unix client can only connect to unix endpoints.");
+        }
+
+        return socket_->connect_async(remote_ep);
+    }
+
+    void unix_client::connect(const std::string& path)
+    {
+        socket_->connect(endpoint::unix_path(path));
+    }
+
+    std::future<void> unix_client::connect_async(const std::string& path)
+    {
+        return socket_->connect_async(endpoint::unix_path(path));
+    }
+
+    size_t unix_client::send_descriptors(gsl::span<const socket::native_handle_type> descriptors,
+                                         gsl::span<const uint8_t> data)
+    {
+        return socket_->send_descriptors(descriptors, data);
+    }
+
+    size_t unix_client::receive_descriptors(gsl::span<uint8_t> buffer,
+                                            std::vector<socket::native_handle_type>& descriptors)
+    {
+        return socket_->receive_descriptors(buffer, descriptors);
+    }
+
+    const std::shared_ptr<network_stream>& unix_client::stream()
+    {
+        if (!socket_->connected())
+        {
+            throw std::runtime_error("Can't retrieve stream for unconnected client.");
+        }
+        if (stream_ == nullptr)
+        {
+            stream_ = std::make_shared<network_stream>(socket_, true);
+        }
+
+        return stream_;
+    }
+}
@@ -0,0 +1,147 @@
+#include <exa/unix_listener.hpp>
+#include <exa/task.hpp>
+#include <exa/detail/io_task.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace std::chrono_literals;
+
+namespace exa
+{
+    unix_listener::unix_listener(const std::string& path) : unix_listener(endpoint::unix_path(path))
+    {
+    }
+
+    unix_listener::unix_listener(const endpoint& ep) : endpoint_(ep)
+    {
+        if (ep.family() != address_family::unix_descriptor)
+        {
+            throw std::invalid_argument("Unix listener needs a unix endpoint.");
+        }
+
+        socket_ = std::make_shared<exa::socket>(address_family::unix_descriptor, socket_type::stream,
+                                                protocol_type::unspecified);
+    }
+
+    unix_listener::~unix_listener()
+    {
+        stop();
+    }
+
+    bool unix_listener::active() const
+    {
+        return active_;
+    }
+
+    endpoint unix_listener::local_endpoint() const
+    {
+        if (socket_->bound())
+        {
+            return socket_->local_endpoint();
+        }
+        else
+        {
+            return endpoint_;
+        }
+    }
+
+    const std::shared_ptr<socket>& unix_listener::socket() const
+    {
+        return socket_;
+    }
+
+    std::shared_ptr<exa::socket> unix_listener::accept_socket() const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("Unix listener isn't actively listening.");
+        }
+
+        return socket_->accept();
+    }
+
+    std::future<std::shared_ptr<exa::socket>> unix_listener::accept_socket_async() const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("Unix listener isn't actively listening.");
+        }
+
+        return socket_->accept_async();
+    }
+
+    std::shared_ptr<unix_client> unix_listener::accept_client() const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("Unix listener isn't actively listening.");
+        }
+
+        return std::make_shared<unix_client>(socket_->accept());
+    }
+
+    std::future<std::shared_ptr<unix_client>> unix_listener::accept_client_async() const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("Unix listener isn't actively listening.");
+        }
+
+        return detail::io_task::run<std::shared_ptr<unix_client>>([=] {
+            return socket_->poll(0us, select_mode::read)
+                       ? std::make_tuple(true, std::make_shared<unix_client>(socket_->accept()))
+                       : std::make_tuple(false, std::shared_ptr<unix_client>());
+        });
+    }
+
+    bool unix_listener::pending() const
+    {
+        if (!active_)
+        {
+            throw std::runtime_error("Unix listener isn't actively listening.");
+        }
+
+        return socket_->poll(0us, select_mode::read);
+    }
+
+    void unix_listener::start(size_t backlog)
+    {
+        if (backlog == 0 || backlog > max_connections)
+        {
+            throw std::out_of_range("Backlog value needs to within specified range of (0, 0x7fffffff].");
+        }
+        if (active_)
+        {
+            return;
+        }
+
+        socket_->bind(endpoint_);
+
+        try
+        {
+            socket_->listen(backlog);
+        }
+        catch (...)
+        {
+            stop();
+            std::rethrow_exception(std::current_exception());
+        }
+
+        active_ = true;
+    }
+
+    void unix_listener::stop()
+    {
+        auto bound = socket_->bound();
+        socket_->close();
+        socket_ = std::make_shared<exa::socket>(address_family::unix_descriptor, socket_type::stream,
+                                                protocol_type::unspecified);
+        active_ = false;
+
+        if (bound && !endpoint_.abstract())
+        {
+            std::remove(endpoint_.path().c_str());
+        }
+    }
+}
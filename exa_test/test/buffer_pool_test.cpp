@@ -0,0 +1,31 @@
+#include <pch.h>
+#include <exa/buffer_pool.hpp>
+
+using namespace exa;
+using namespace testing;
+
+TEST(buffer_pool_test, ctor_invalid_size_throws)
+{
+    ASSERT_THROW(buffer_pool p(0), std::out_of_range);
+}
+
+TEST(buffer_pool_test, released_buffers_are_reused)
+{
+    buffer_pool p(64, 1);
+
+    auto a = p.acquire();
+    auto b = p.acquire();
+    ASSERT_THAT(a.size(), Eq(64));
+    auto data = a.data();
+
+    p.release(std::move(a));
+    p.release(std::move(b));
+    ASSERT_THAT(p.available(), Eq(1));
+
+    auto c = p.acquire();
+    ASSERT_THAT(c.data(), Eq(data));
+    ASSERT_THAT(p.available(), Eq(0));
+
+    p.release(std::vector<uint8_t>(8));
+    ASSERT_THAT(p.available(), Eq(0));
+}
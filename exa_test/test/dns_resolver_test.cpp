@@ -0,0 +1,193 @@
+#include <pch.h>
+#include <exa/dns_resolver.hpp>
+#include <exa/udp_client.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    class stub_name_server
+    {
+    public:
+        stub_name_server() : client_(endpoint(address::loopback, 0))
+        {
+            thread_ = std::thread([this] {
+                while (run_)
+                {
+                    if (!client_.socket()->poll(10ms, select_mode::read))
+                    {
+                        continue;
+                    }
+
+                    endpoint ep;
+                    auto query = client_.receive(ep);
+                    queries_ += 1;
+                    client_.send(respond(query), ep);
+                }
+            });
+        }
+
+        ~stub_name_server()
+        {
+            run_ = false;
+            thread_.join();
+        }
+
+        endpoint local_endpoint() const
+        {
+            return client_.socket()->local_endpoint();
+        }
+
+        int queries() const
+        {
+            return queries_;
+        }
+
+    private:
+        static std::vector<uint8_t> respond(std::vector<uint8_t> query)
+        {
+            auto type = static_cast<uint16_t>((query[query.size() - 4] << 8) | query[query.size() - 3]);
+            auto exists = std::search(std::begin(query), std::end(query), std::begin(existing_label),
+                                      std::end(existing_label)) != std::end(query);
+
+            query[2] = 0x81;
+            query[3] = exists ? 0x80 : 0x83;
+
+            if (exists && type == 1)
+            {
+                query[7] = 1;
+                query.insert(std::end(query), {0xc0, 0x0c, 0, 1, 0, 1, 0, 0, 0, 60, 0, 4, 10, 0, 0, 1});
+            }
+
+            return query;
+        }
+
+        static constexpr std::array<uint8_t, 8> existing_label = {7, 'e', 'x', 'a', 'm', 'p', 'l', 'e'};
+
+        udp_client client_;
+        std::atomic_bool run_{true};
+        std::atomic_int queries_{0};
+        std::thread thread_;
+    };
+
+    dns_resolver_options stub_options(const stub_name_server& server)
+    {
+        dns_resolver_options options;
+        options.name_servers = {server.local_endpoint()};
+        options.use_hosts = false;
+        options.family = address_family::inter_network;
+        options.timeout = 500ms;
+        return options;
+    }
+}
+
+TEST(dns_resolver_test, ctor_invalid_options_throws)
+{
+    dns_resolver_options options;
+    options.attempts = 0;
+    ASSERT_THROW(dns_resolver r(options), std::out_of_range);
+
+    options.attempts = 1;
+    options.timeout = 0ms;
+    ASSERT_THROW(dns_resolver r(options), std::out_of_range);
+}
+
+TEST(dns_resolver_test, literal_address_resolves_without_query)
+{
+    stub_name_server server;
+    dns_resolver r(stub_options(server));
+
+    auto endpoints = r.resolve("127.0.0.1", 80);
+    ASSERT_THAT(endpoints.size(), Eq(1));
+    ASSERT_THAT(endpoints[0].address().to_string(), Eq("127.0.0.1"));
+    ASSERT_THAT(endpoints[0].port(), Eq(80));
+    ASSERT_THAT(server.queries(), Eq(0));
+}
+
+TEST(dns_resolver_test, hosts_file_resolves_without_query)
+{
+    auto path = "dns_resolver_test_hosts";
+    std::ofstream(path) << "# comment\n10.1.2.3 MyHost.test alias # trailing\n::1 myhost.test\n";
+
+    stub_name_server server;
+    auto options = stub_options(server);
+    options.use_hosts = true;
+    options.hosts_path = path;
+    dns_resolver r(options);
+
+    auto addresses = r.lookup("myhost.test.");
+    ASSERT_THAT(addresses.size(), Eq(2));
+    ASSERT_THAT(addresses[0].to_string(), Eq("10.1.2.3"));
+    ASSERT_THAT(addresses[1].family(), Eq(address_family::inter_network_v6));
+    ASSERT_THAT(r.lookup("ALIAS")[0].to_string(), Eq("10.1.2.3"));
+    ASSERT_THAT(server.queries(), Eq(0));
+
+    std::remove(path);
+}
+
+TEST(dns_resolver_test, positive_answer_is_cached)
+{
+    stub_name_server server;
+    dns_resolver r(stub_options(server));
+
+    auto endpoints = r.resolve("example.test", 443);
+    ASSERT_THAT(endpoints.size(), Eq(1));
+    ASSERT_THAT(endpoints[0].address().to_string(), Eq("10.0.0.1"));
+    ASSERT_THAT(endpoints[0].port(), Eq(443));
+    ASSERT_THAT(server.queries(), Eq(1));
+
+    ASSERT_THAT(r.lookup("Example.Test")[0].to_string(), Eq("10.0.0.1"));
+    ASSERT_THAT(server.queries(), Eq(1));
+    ASSERT_THAT(r.cache_entries(), Eq(1));
+
+    r.clear_cache();
+    ASSERT_THAT(r.lookup("example.test")[0].to_string(), Eq("10.0.0.1"));
+    ASSERT_THAT(server.queries(), Eq(2));
+}
+
+TEST(dns_resolver_test, negative_answer_is_cached)
+{
+    stub_name_server server;
+    dns_resolver r(stub_options(server));
+
+    ASSERT_THROW(r.lookup("missing.test"), std::runtime_error);
+    ASSERT_THAT(server.queries(), Eq(1));
+    ASSERT_THROW(r.resolve("missing.test", 80), std::runtime_error);
+    ASSERT_THAT(server.queries(), Eq(1));
+}
+
+TEST(dns_resolver_test, concurrent_lookups_are_deduplicated)
+{
+    stub_name_server server;
+    dns_resolver r(stub_options(server));
+
+    std::vector<std::shared_future<std::vector<address>>> lookups;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        lookups.push_back(r.lookup_async("example.test"));
+    }
+
+    for (auto& f : lookups)
+    {
+        ASSERT_THAT(f.get()[0].to_string(), Eq("10.0.0.1"));
+    }
+
+    ASSERT_THAT(server.queries(), Eq(1));
+}
+
+TEST(dns_resolver_test, unresponsive_server_times_out)
+{
+    udp_client silent(endpoint(address::loopback, 0));
+    dns_resolver_options options;
+    options.name_servers = {silent.socket()->local_endpoint()};
+    options.use_hosts = false;
+    options.timeout = 50ms;
+    options.attempts = 2;
+    dns_resolver r(options);
+
+    ASSERT_THROW(r.lookup("example.test"), std::runtime_error);
+    ASSERT_THAT(r.cache_entries(), Eq(0));
+}
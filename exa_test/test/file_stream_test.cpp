@@ -39,6 +39,7 @@ class file_stream_test : public Test
     virtual void TearDown() override
     {
         fremove("1.txt");
+        fremove("2.txt");
     }
 };
 
@@ -123,3 +124,50 @@ TEST_F(file_stream_test, data_equal_after_writing_and_reading)
     ASSERT_THAT(static_cast<size_t>(s.read_async(b).get()), Eq(v.size()));
     ASSERT_THAT(b, ContainerEq(v));
 }
+
+TEST_F(file_stream_test, copy_to_sparse_file_keeps_data_and_size)
+{
+    auto head = std::vector<uint8_t>({'f', 'o', 'o'});
+    auto tail = std::vector<uint8_t>({'b', 'a', 'r'});
+    auto from = std::make_shared<file_stream>("1.txt", file_mode::create);
+    from->write(head);
+    from->position(1 << 20);
+    from->write(tail);
+    from->size(3 << 20);
+    from->position(0);
+
+    auto to = std::make_shared<file_stream>("2.txt", file_mode::create);
+    from->copy_to(to);
+
+    ASSERT_THAT(from->position(), Eq(3 << 20));
+    ASSERT_THAT(to->position(), Eq(3 << 20));
+    ASSERT_THAT(to->size(), Eq(3 << 20));
+
+    std::vector<uint8_t> b(3);
+    to->position(0);
+    to->read(b);
+    ASSERT_THAT(b, ContainerEq(head));
+    to->position(1 << 20);
+    to->read(b);
+    ASSERT_THAT(b, ContainerEq(tail));
+    to->position(2 << 20);
+    to->read(b);
+    ASSERT_THAT(b, ElementsAre(0, 0, 0));
+}
+
+TEST_F(file_stream_test, copy_to_from_current_position)
+{
+    auto v = "foo\nbar\n42\n"s;
+    auto from = std::make_shared<file_stream>("1.txt", file_mode::create);
+    from->write({reinterpret_cast<const uint8_t*>(v.data()), static_cast<ptrdiff_t>(v.size())});
+    from->position(4);
+
+    auto to = std::make_shared<file_stream>("2.txt", file_mode::create);
+    to->write_byte('x');
+    from->copy_to(to);
+
+    std::vector<uint8_t> b(static_cast<size_t>(to->size()));
+    to->position(0);
+    to->read(b);
+    ASSERT_THAT(std::string(std::begin(b), std::end(b)), Eq("xbar\n42\n"));
+}
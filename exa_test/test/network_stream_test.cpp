@@ -1,6 +1,7 @@
 #include <pch.h>
 #include <exa/network_stream.hpp>
 #include <exa/memory_stream.hpp>
+#include <exa/file_stream.hpp>
 #include <exa/task.hpp>
 
 using namespace exa;
@@ -362,6 +363,173 @@ TEST(network_stream_test, read_write_array_success)
     ASSERT_THAT(client_data, ContainerEq(server_data));
 }
 
+TEST(network_stream_test, read_write_vectored_success)
+{
+    auto listener = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+    auto client = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+
+    listener->bind(address::loopback, 0);
+    listener->listen(1);
+
+    auto f = client->connect_async(address::loopback, listener->local_endpoint().port());
+    auto server = listener->accept_async().get();
+    f.get();
+
+    auto server_stream = std::make_shared<network_stream>(server);
+    auto client_stream = std::make_shared<network_stream>(client);
+
+    std::vector<uint8_t> header({1, 2, 3, 4});
+    std::vector<uint8_t> payload(100, 5);
+    std::vector<uint8_t> trailer({6, 7});
+    std::array<gsl::span<const uint8_t>, 3> frame = {header, payload, trailer};
+    client_stream->write(frame);
+
+    std::vector<uint8_t> server_header(4, 0);
+    std::vector<uint8_t> server_body(102, 0);
+    std::array<gsl::span<uint8_t>, 2> buffers = {server_header, server_body};
+
+    ASSERT_THAT(server_stream->read(buffers), Eq(106));
+    ASSERT_THAT(server_header, ContainerEq(header));
+    ASSERT_THAT(server_body[99], Eq(5));
+    ASSERT_THAT(server_body[100], Eq(6));
+    ASSERT_THAT(server_body[101], Eq(7));
+}
+
+TEST(network_stream_test, read_write_vectored_async_success)
+{
+    auto listener = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+    auto client = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+
+    listener->bind(address::loopback, 0);
+    listener->listen(1);
+
+    auto f = client->connect_async(address::loopback, listener->local_endpoint().port());
+    auto server = listener->accept_async().get();
+    f.get();
+
+    auto server_stream = std::make_shared<network_stream>(server);
+    auto client_stream = std::make_shared<network_stream>(client);
+
+    std::vector<uint8_t> first({'a', 'b'});
+    std::vector<uint8_t> second({'c'});
+    std::array<gsl::span<const uint8_t>, 2> frame = {first, second};
+    client_stream->write_async(frame).get();
+
+    std::vector<uint8_t> a(1, 0);
+    std::vector<uint8_t> b(2, 0);
+    std::array<gsl::span<uint8_t>, 2> buffers = {a, b};
+
+    ASSERT_THAT(server_stream->read_async(buffers).get(), Eq(3));
+    ASSERT_THAT(a[0], Eq('a'));
+    ASSERT_THAT(b, ElementsAre('b', 'c'));
+}
+
+TEST(network_stream_test, copy_to_file_and_from_file_success)
+{
+    auto listener = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+    auto client = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+
+    listener->bind(address::loopback, 0);
+    listener->listen(1);
+
+    auto f = client->connect_async(address::loopback, listener->local_endpoint().port());
+    auto server = listener->accept_async().get();
+    f.get();
+
+    std::vector<uint8_t> data(300000);
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i % 251);
+    }
+
+    {
+        auto source = std::make_shared<file_stream>("network_stream_source", file_mode::create);
+        source->write(data);
+        source->position(0);
+
+        auto sent = source->copy_to_async(std::make_shared<network_stream>(client));
+        std::vector<uint8_t> received(data.size());
+        size_t n = 0;
+
+        while (n < received.size())
+        {
+            n += server->receive(gsl::span<uint8_t>(received).subspan(static_cast<std::ptrdiff_t>(n)));
+        }
+
+        sent.get();
+        ASSERT_THAT(received, ContainerEq(data));
+    }
+
+    {
+        auto target = std::make_shared<file_stream>("network_stream_target", file_mode::create);
+        // The stream has to outlive the copy running on it.
+        auto server_stream = std::make_shared<network_stream>(server);
+        auto copied = server_stream->copy_to_async(target);
+        client->send(data);
+        client->shutdown(socket_shutdown::write);
+        copied.get();
+
+        std::vector<uint8_t> written(data.size());
+        ASSERT_THAT(target->size(), Eq(static_cast<std::streamsize>(data.size())));
+        target->position(0);
+        target->read(written);
+        ASSERT_THAT(written, ContainerEq(data));
+    }
+
+    std::remove("network_stream_source");
+    std::remove("network_stream_target");
+}
+
+TEST(network_stream_test, copy_to_slow_socket_past_write_timeout_copies_all_data)
+{
+    auto connect_pair = [] {
+        auto listener =
+            std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+        auto client = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+        listener->bind(address::loopback, 0);
+        listener->listen(1);
+        auto f = client->connect_async(address::loopback, listener->local_endpoint().port());
+        auto server = listener->accept_async().get();
+        f.get();
+        return std::make_pair(client, server);
+    };
+
+    auto [sender, relay_in] = connect_pair();
+    auto [relay_out, receiver] = connect_pair();
+    relay_out->send_buffer(4096);
+    auto out = std::make_shared<network_stream>(relay_out);
+    out->write_timeout(10ms);
+
+    std::vector<uint8_t> data(1024 * 1024);
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i % 251);
+    }
+
+    // The output fills up while the receiver isn't reading, so moving data out of the pipe has to wait.
+    auto in = std::make_shared<network_stream>(relay_in);
+    auto copied = in->copy_to_async(out);
+    std::thread writer([&, sender = sender] {
+        sender->send(data);
+        sender->shutdown(socket_shutdown::write);
+    });
+    std::this_thread::sleep_for(100ms);
+
+    std::vector<uint8_t> received(data.size());
+    size_t n = 0;
+
+    while (n < received.size())
+    {
+        n += receiver->receive(gsl::span<uint8_t>(received).subspan(static_cast<std::ptrdiff_t>(n)));
+    }
+
+    writer.join();
+    copied.get();
+    ASSERT_THAT(received, ContainerEq(data));
+}
+
 TEST(network_stream_test, read_timeout_expires_throws)
 {
     auto listener = std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
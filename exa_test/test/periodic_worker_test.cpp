@@ -0,0 +1,58 @@
+#include <pch.h>
+#include <exa/periodic_worker.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(periodic_worker_test, calls_work_until_stopped)
+{
+    detail::periodic_worker w;
+    std::atomic_int calls{0};
+
+    w.start(1ms, [&] { calls += 1; });
+    ASSERT_TRUE(w.running());
+
+    for (int i = 0; i < 400 && calls < 3; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    w.stop();
+    ASSERT_FALSE(w.running());
+    auto stopped = calls.load();
+    ASSERT_THAT(stopped, Ge(3));
+    std::this_thread::sleep_for(10ms);
+    ASSERT_THAT(calls.load(), Eq(stopped));
+}
+
+TEST(periodic_worker_test, concurrent_start_and_stop_are_safe)
+{
+    detail::periodic_worker w;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 50; ++j)
+            {
+                if ((i + j) % 2 == 0)
+                {
+                    w.start(1ms, [] {});
+                }
+                else
+                {
+                    w.stop();
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    w.stop();
+    ASSERT_FALSE(w.running());
+}
@@ -0,0 +1,122 @@
+#include <pch.h>
+#include <exa/poller.hpp>
+#include <exa/enum_flag.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    auto create_udp_socket()
+    {
+        auto s = std::make_shared<exa::socket>(address_family::inter_network, socket_type::datagram, protocol_type::udp);
+        s->bind(address::loopback, 0);
+        return s;
+    }
+}
+
+TEST(poller_test, add_remove_changes_size)
+{
+    poller p;
+    auto s = create_udp_socket();
+
+    ASSERT_THAT(p.size(), Eq(0));
+    p.add(s, poll_events::read);
+    ASSERT_THAT(p.size(), Eq(1));
+    ASSERT_TRUE(p.contains(s));
+    ASSERT_THROW(p.add(s, poll_events::read), std::invalid_argument);
+
+    p.remove(s);
+    ASSERT_THAT(p.size(), Eq(0));
+    ASSERT_FALSE(p.contains(s));
+    ASSERT_THROW(p.modify(s, poll_events::write), std::invalid_argument);
+}
+
+TEST(poller_test, invalid_arguments_throw)
+{
+    poller p;
+    std::vector<poll_event> events;
+
+    ASSERT_THROW(p.add(nullptr, poll_events::read), std::invalid_argument);
+    ASSERT_THROW(p.wait(events, 0ms), std::invalid_argument);
+}
+
+TEST(poller_test, wait_reports_only_ready_sockets)
+{
+    poller p;
+    std::vector<std::shared_ptr<exa::socket>> sockets;
+
+    for (int i = 0; i < 64; ++i)
+    {
+        sockets.push_back(create_udp_socket());
+        p.add(sockets.back(), poll_events::read, reinterpret_cast<void*>(static_cast<uintptr_t>(i + 1)));
+    }
+
+    std::vector<poll_event> events(16);
+    ASSERT_THAT(p.wait(events, 0ms), Eq(0));
+
+    auto& ready = sockets[42];
+    sockets[0]->send_to(std::vector<uint8_t>({1}), ready->local_endpoint());
+
+    auto n = p.wait(events, 5000ms);
+    ASSERT_THAT(n, Eq(1));
+    ASSERT_THAT(events[0].socket, Eq(ready));
+    ASSERT_TRUE(has_flag(events[0].events, poll_events::read));
+    ASSERT_THAT(reinterpret_cast<uintptr_t>(events[0].user_data), Eq(43));
+}
+
+TEST(poller_test, modify_changes_interest_and_user_data)
+{
+    poller p;
+    auto s = create_udp_socket();
+    int data = 0;
+    std::vector<poll_event> events(1);
+
+    p.add(s, poll_events::read);
+    ASSERT_THAT(p.wait(events, 0ms), Eq(0));
+
+    p.modify(s, poll_events::write, &data);
+    ASSERT_THAT(p.wait(events, 1000ms), Eq(1));
+    ASSERT_TRUE(has_flag(events[0].events, poll_events::write));
+    ASSERT_THAT(events[0].user_data, Eq(&data));
+}
+
+TEST(poller_test, one_shot_fires_once)
+{
+    poller p;
+    auto s = create_udp_socket();
+    std::vector<poll_event> events(1);
+
+    p.add(s, poll_events::write | poll_events::one_shot);
+    ASSERT_THAT(p.wait(events, 1000ms), Eq(1));
+    ASSERT_THAT(p.wait(events, 0ms), Eq(0));
+
+    p.modify(s, poll_events::write | poll_events::one_shot);
+    ASSERT_THAT(p.wait(events, 1000ms), Eq(1));
+}
+
+TEST(poller_test, notify_wakes_waiter)
+{
+    poller p;
+    std::vector<poll_event> events(1);
+    auto start = std::chrono::steady_clock::now();
+    auto f = std::async(std::launch::async, [&] { return p.wait(events, -1ms); });
+
+    std::this_thread::sleep_for(10ms);
+    p.notify();
+
+    ASSERT_THAT(f.get(), Eq(0));
+    ASSERT_THAT(std::chrono::steady_clock::now() - start, Lt(5s));
+}
+
+TEST(poller_test, closed_socket_can_be_removed)
+{
+    poller p;
+    auto s = create_udp_socket();
+    p.add(s, poll_events::read);
+    s->close();
+
+    ASSERT_NO_THROW(p.remove(s));
+    ASSERT_THAT(p.size(), Eq(0));
+}
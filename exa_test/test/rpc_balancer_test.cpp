@@ -0,0 +1,210 @@
+#include <pch.h>
+#include <exa/rpc_balancer.hpp>
+#include <exa/rpc_server.hpp>
+#include <exa/tcp_listener.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    class counting_server
+    {
+    public:
+        explicit counting_server(std::chrono::milliseconds delay = 0ms, const address& addr = address::loopback)
+        {
+            tcp_server_options options;
+            options.io_loops = 1;
+
+            server_ = std::make_unique<rpc_server>(endpoint(addr, 0),
+                                                   [this, delay](auto request, auto&& respond) {
+                                                       calls_ += 1;
+                                                       std::this_thread::sleep_for(delay);
+                                                       respond.reply(request);
+                                                   },
+                                                   rpc_options(), options);
+            server_->start();
+        }
+
+        endpoint local_endpoint() const
+        {
+            return server_->local_endpoint();
+        }
+
+        int calls() const
+        {
+            return calls_;
+        }
+
+        void stop()
+        {
+            server_->stop();
+        }
+
+    private:
+        std::atomic_int calls_{0};
+        std::unique_ptr<rpc_server> server_;
+    };
+
+    endpoint unused_endpoint()
+    {
+        tcp_listener l(address::loopback, 0);
+        l.start();
+        return l.local_endpoint();
+    }
+}
+
+TEST(rpc_balancer_test, ctor_invalid_args_throws)
+{
+    ASSERT_THROW(rpc_balancer b{std::vector<endpoint>()}, std::invalid_argument);
+
+    counting_server server;
+    rpc_balancer_options options;
+    options.latency_weight = 0;
+    ASSERT_THROW(rpc_balancer b({server.local_endpoint()}, options), std::out_of_range);
+}
+
+TEST(rpc_balancer_test, least_outstanding_spreads_calls)
+{
+    std::mutex mutex;
+    std::vector<rpc_responder> held;
+    std::vector<std::unique_ptr<rpc_server>> servers;
+    std::vector<endpoint> endpoints;
+    tcp_server_options options;
+    options.io_loops = 1;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        servers.push_back(std::make_unique<rpc_server>(endpoint(address::loopback, 0),
+                                                       [&](auto, auto&& respond) {
+                                                           std::lock_guard<std::mutex> l(mutex);
+                                                           held.push_back(respond);
+                                                       },
+                                                       rpc_options(), options));
+        servers.back()->start();
+        endpoints.push_back(servers.back()->local_endpoint());
+    }
+
+    rpc_balancer b(endpoints);
+    std::vector<std::future<std::vector<uint8_t>>> calls;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        calls.push_back(b.call(std::vector<uint8_t>{1}));
+    }
+
+    for (auto& s : b.status())
+    {
+        ASSERT_THAT(s.outstanding, Eq(2));
+    }
+
+    for (int i = 0; i < 200 && [&] { std::lock_guard<std::mutex> l(mutex); return held.size(); }() < 4; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(mutex);
+
+        for (auto& respond : held)
+        {
+            respond.reply(std::vector<uint8_t>{2});
+        }
+    }
+
+    for (auto& c : calls)
+    {
+        ASSERT_THAT(c.get(), ElementsAre(2));
+    }
+}
+
+TEST(rpc_balancer_test, lowest_latency_prefers_fast_backend)
+{
+    counting_server fast;
+    counting_server slow(20ms);
+
+    rpc_balancer_options options;
+    options.policy = rpc_balance_policy::lowest_latency;
+    rpc_balancer b({fast.local_endpoint(), slow.local_endpoint()}, options);
+
+    for (int i = 0; i < 20; ++i)
+    {
+        ASSERT_THAT(b.call(std::vector<uint8_t>{3}).get(), ElementsAre(3));
+    }
+
+    ASSERT_THAT(slow.calls(), Le(2));
+    ASSERT_THAT(fast.calls(), Ge(18));
+}
+
+TEST(rpc_balancer_test, failed_and_slow_backends_are_ejected)
+{
+    counting_server healthy;
+    counting_server failing;
+    counting_server slow(20ms);
+
+    rpc_balancer_options options;
+    options.max_latency = 10ms;
+    options.ejection_time = 1min;
+    rpc_balancer b({healthy.local_endpoint(), failing.local_endpoint(), slow.local_endpoint()}, options);
+    ASSERT_THAT(b.available(), Eq(3));
+
+    failing.stop();
+
+    for (int i = 0; i < 20; ++i)
+    {
+        try
+        {
+            b.call(std::vector<uint8_t>{4}).get();
+        }
+        catch (const std::runtime_error&)
+        {
+            // Calls in flight on the failing backend when it went away.
+        }
+    }
+
+    auto status = b.status();
+    ASSERT_FALSE(status[0].ejected);
+    ASSERT_TRUE(status[1].ejected);
+    ASSERT_TRUE(status[2].ejected);
+    ASSERT_THAT(status[2].ejections, Eq(1));
+    ASSERT_THAT(b.available(), Eq(1));
+    ASSERT_THAT(b.call(std::vector<uint8_t>{5}).get(), ElementsAre(5));
+}
+
+TEST(rpc_balancer_test, no_backend_available_throws)
+{
+    rpc_balancer b({unused_endpoint()});
+    ASSERT_THAT(b.available(), Eq(0));
+    ASSERT_THROW(b.call(std::vector<uint8_t>{1}), std::runtime_error);
+}
+
+TEST(rpc_balancer_test, ipv6_backend_connects)
+{
+    counting_server server(0ms, address::ipv6_loopback);
+    rpc_balancer b({server.local_endpoint()});
+    ASSERT_THAT(b.available(), Eq(1));
+    ASSERT_THAT(b.call(std::vector<uint8_t>{6}).get(), ElementsAre(6));
+}
+
+TEST(rpc_balancer_test, ejected_backend_revives_in_background)
+{
+    counting_server slow(20ms);
+
+    rpc_balancer_options options;
+    options.max_latency = 10ms;
+    options.ejection_time = 50ms;
+    rpc_balancer b({slow.local_endpoint()}, options);
+
+    ASSERT_THAT(b.call(std::vector<uint8_t>{7}).get(), ElementsAre(7));
+    ASSERT_THAT(b.available(), Eq(0));
+
+    // Comes back without a call picking it up.
+    for (int i = 0; i < 100 && b.available() == 0; ++i)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    ASSERT_THAT(b.available(), Eq(1));
+    ASSERT_THAT(b.status()[0].ejections, Eq(1));
+}
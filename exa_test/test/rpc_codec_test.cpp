@@ -0,0 +1,48 @@
+#include <pch.h>
+#include <exa/rpc_codec.hpp>
+
+using namespace exa;
+using namespace testing;
+
+TEST(rpc_codec_test, ctor_invalid_frame_size_throws)
+{
+    ASSERT_THROW(rpc_codec c(0), std::out_of_range);
+}
+
+TEST(rpc_codec_test, decode_reassembles_split_frames)
+{
+    std::vector<uint8_t> data;
+    rpc_codec::encode(data, rpc_frame_kind::request, 1, std::vector<uint8_t>{1, 2, 3});
+    rpc_codec::encode(data, rpc_frame_kind::response, 0x0102030405060708, std::vector<uint8_t>());
+    ASSERT_THAT(data.size(), Eq(2 * rpc_codec::header_size + 3));
+    ASSERT_THAT(data[3], Eq(3));
+
+    rpc_codec c;
+    std::vector<rpc_frame> frames;
+
+    for (auto b : data)
+    {
+        for (auto& f : c.decode(std::vector<uint8_t>{b}))
+        {
+            frames.push_back(f);
+        }
+    }
+
+    ASSERT_THAT(frames.size(), Eq(2));
+    ASSERT_THAT(frames[0].kind, Eq(rpc_frame_kind::request));
+    ASSERT_THAT(frames[0].id, Eq(1));
+    ASSERT_THAT(frames[0].payload, ElementsAre(1, 2, 3));
+    ASSERT_THAT(frames[1].kind, Eq(rpc_frame_kind::response));
+    ASSERT_THAT(frames[1].id, Eq(0x0102030405060708));
+    ASSERT_TRUE(frames[1].payload.empty());
+    ASSERT_THAT(c.buffered(), Eq(0));
+}
+
+TEST(rpc_codec_test, decode_oversized_frame_throws)
+{
+    std::vector<uint8_t> data;
+    rpc_codec::encode(data, rpc_frame_kind::request, 1, std::vector<uint8_t>(16));
+
+    rpc_codec c(8);
+    ASSERT_THROW(c.decode(data), std::runtime_error);
+}
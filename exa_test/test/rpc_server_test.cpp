@@ -0,0 +1,154 @@
+#include <pch.h>
+#include <exa/rpc_client.hpp>
+#include <exa/rpc_server.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    std::shared_ptr<tcp_client> connect(const rpc_server& server)
+    {
+        auto c = std::make_shared<tcp_client>();
+        c->connect(server.local_endpoint());
+        return c;
+    }
+
+    tcp_server_options single_loop()
+    {
+        tcp_server_options options;
+        options.io_loops = 1;
+        return options;
+    }
+}
+
+TEST(rpc_server_test, pipelined_calls_roundtrip)
+{
+    rpc_server server(endpoint(address::loopback, 0),
+                      [](auto request, auto&& respond) {
+                          std::vector<uint8_t> response(std::begin(request), std::end(request));
+                          std::reverse(std::begin(response), std::end(response));
+                          respond.reply(response);
+                      },
+                      rpc_options(), single_loop());
+    server.start();
+
+    rpc_client client(connect(server));
+    std::vector<std::future<std::vector<uint8_t>>> calls;
+
+    for (uint8_t i = 0; i < 100; ++i)
+    {
+        calls.push_back(client.call(std::vector<uint8_t>{i, 1}));
+    }
+
+    for (uint8_t i = 0; i < 100; ++i)
+    {
+        ASSERT_THAT(calls[i].get(), ElementsAre(1, i));
+    }
+
+    ASSERT_THAT(client.outstanding(), Eq(0));
+}
+
+TEST(rpc_server_test, responses_match_out_of_order)
+{
+    std::mutex mutex;
+    std::vector<std::pair<uint8_t, rpc_responder>> held;
+
+    rpc_server server(endpoint(address::loopback, 0),
+                      [&](auto request, auto&& respond) {
+                          std::lock_guard<std::mutex> l(mutex);
+                          held.emplace_back(request[0], respond);
+                      },
+                      rpc_options(), single_loop());
+    server.start();
+
+    rpc_client client(connect(server));
+    auto first = client.call(std::vector<uint8_t>{1});
+    auto second = client.call(std::vector<uint8_t>{2});
+
+    for (int i = 0; i < 200 && [&] { std::lock_guard<std::mutex> l(mutex); return held.size(); }() < 2; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    std::lock_guard<std::mutex> l(mutex);
+    ASSERT_THAT(held.size(), Eq(2));
+    std::reverse(std::begin(held), std::end(held));
+
+    for (auto& [value, respond] : held)
+    {
+        respond.reply(std::vector<uint8_t>{static_cast<uint8_t>(value * 10)});
+    }
+
+    ASSERT_THAT(second.get(), ElementsAre(20));
+    ASSERT_THAT(first.get(), ElementsAre(10));
+}
+
+TEST(rpc_server_test, handler_exception_fails_call)
+{
+    rpc_server server(endpoint(address::loopback, 0),
+                      [](auto, auto&&) -> void { throw std::logic_error("bad request"); }, rpc_options(),
+                      single_loop());
+    server.start();
+
+    rpc_client client(connect(server));
+
+    try
+    {
+        client.call(std::vector<uint8_t>{1}).get();
+        FAIL();
+    }
+    catch (const std::runtime_error& e)
+    {
+        ASSERT_THAT(std::string(e.what()), Eq("bad request"));
+    }
+
+    ASSERT_FALSE(client.closed());
+}
+
+TEST(rpc_server_test, outstanding_calls_are_bounded)
+{
+    std::mutex mutex;
+    std::vector<rpc_responder> held;
+
+    rpc_server server(endpoint(address::loopback, 0),
+                      [&](auto, auto&& respond) {
+                          std::lock_guard<std::mutex> l(mutex);
+                          held.push_back(respond);
+                      },
+                      rpc_options(), single_loop());
+    server.start();
+
+    rpc_options options;
+    options.max_outstanding = 2;
+    rpc_client client(connect(server), options);
+
+    auto a = client.call(std::vector<uint8_t>{1});
+    auto b = client.call(std::vector<uint8_t>{2});
+    auto c = std::async(std::launch::async, [&] { return client.call(std::vector<uint8_t>{3}).get(); });
+    ASSERT_THAT(c.wait_for(50ms), Eq(std::future_status::timeout));
+    ASSERT_THAT(client.outstanding(), Eq(2));
+
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        held[0].reply(std::vector<uint8_t>{1});
+    }
+
+    ASSERT_THAT(a.get(), ElementsAre(1));
+
+    for (int i = 0; i < 200 && [&] { std::lock_guard<std::mutex> l(mutex); return held.size(); }() < 3; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        held[2].reply(std::vector<uint8_t>{3});
+    }
+
+    ASSERT_THAT(c.get(), ElementsAre(3));
+    client.close();
+    ASSERT_THROW(b.get(), std::runtime_error);
+    ASSERT_THROW(client.call(std::vector<uint8_t>{4}), std::runtime_error);
+}
@@ -0,0 +1,108 @@
+#include <pch.h>
+#include <exa/socket_buffer_tuner.hpp>
+#include <exa/tcp_listener.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(socket_buffer_tuner_test, ctor_invalid_options_throws)
+{
+    socket_buffer_tuner_options options;
+    options.min_buffer = 0;
+    ASSERT_THROW(socket_buffer_tuner t(options), std::out_of_range);
+
+    options.min_buffer = options.max_buffer + 1;
+    ASSERT_THROW(socket_buffer_tuner t(options), std::out_of_range);
+
+    options.min_buffer = 4096;
+    options.headroom = 0.5;
+    ASSERT_THROW(socket_buffer_tuner t(options), std::out_of_range);
+}
+
+TEST(socket_buffer_tuner_test, add_starts_with_minimum_buffers)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+
+    socket_buffer_tuner tuner;
+    tuner.add(client);
+    ASSERT_THROW(tuner.add(std::shared_ptr<exa::socket>()), std::invalid_argument);
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+
+    ASSERT_THAT(tuner.size(), Eq(1));
+    ASSERT_THAT(tuner.memory(), Eq(2 * tuner.options().min_buffer));
+    ASSERT_THAT(client->socket()->tuning().send_buffer, Optional(Ge(tuner.options().min_buffer)));
+    ASSERT_THAT(client->socket()->tuning().receive_buffer, Optional(Ge(tuner.options().min_buffer)));
+
+    client.reset();
+    ASSERT_THAT(tuner.tune(), Eq(0));
+    ASSERT_THAT(tuner.size(), Eq(0));
+}
+
+TEST(socket_buffer_tuner_test, add_keeps_buffers_of_connected_socket)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+    auto send = client->socket()->send_buffer();
+    auto receive = client->socket()->receive_buffer();
+
+    socket_buffer_tuner tuner;
+    tuner.add(client);
+
+    ASSERT_THAT(client->socket()->send_buffer(), Eq(send));
+    ASSERT_THAT(client->socket()->receive_buffer(), Eq(receive));
+    ASSERT_THAT(client->socket()->tuning().send_buffer.has_value(), Eq(false));
+    ASSERT_THAT(tuner.memory(), Eq(send + receive));
+}
+
+TEST(socket_buffer_tuner_test, tune_stays_within_memory_limit)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+
+    socket_buffer_tuner_options options;
+    options.min_buffer = 64 * 1024;
+    options.max_buffer = 4 * 1024 * 1024;
+    options.memory_limit = 512 * 1024;
+    options.headroom = 1000;
+    socket_buffer_tuner tuner(options);
+    tuner.add(client);
+    tuner.add(server->socket());
+
+    std::vector<uint8_t> data(1024 * 1024, 1);
+    auto reader = std::async(std::launch::async, [&] {
+        std::vector<uint8_t> buffer(data.size());
+        size_t n = 0;
+
+        while (n < buffer.size())
+        {
+            n += server->stream()->read(gsl::span<uint8_t>(buffer).subspan(static_cast<std::ptrdiff_t>(n)));
+        }
+    });
+
+    client->stream()->write(data);
+    reader.get();
+
+    ASSERT_THAT(tuner.tune(), Ge(1));
+    ASSERT_THAT(tuner.memory(), Le(options.memory_limit));
+    ASSERT_THAT(*client->socket()->tuning().send_buffer, Gt(options.min_buffer));
+}
+
+TEST(socket_buffer_tuner_test, start_stop_toggles_running)
+{
+    socket_buffer_tuner tuner;
+    ASSERT_THROW(tuner.start(0ms), std::out_of_range);
+    tuner.start(5ms);
+    ASSERT_TRUE(tuner.running());
+    tuner.stop();
+    ASSERT_FALSE(tuner.running());
+}
@@ -0,0 +1,153 @@
+#include <pch.h>
+#include <exa/tcp_client_pool.hpp>
+#include <exa/tcp_listener.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(tcp_client_pool_test, ctor_invalid_options_throws)
+{
+    tcp_client_pool_options options;
+    options.min_idle = 2;
+    options.max_idle = 1;
+    ASSERT_THROW(tcp_client_pool p(options), std::out_of_range);
+
+    options.max_idle = 2;
+    options.max_connections = 1;
+    ASSERT_THROW(tcp_client_pool p(options), std::out_of_range);
+
+    options.max_connections = 0;
+    options.idle_timeout = 0ms;
+    ASSERT_THROW(tcp_client_pool p(options), std::out_of_range);
+}
+
+TEST(tcp_client_pool_test, released_client_is_reused)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+    tcp_client_pool p;
+
+    auto c = p.acquire(ep);
+    auto port = c->socket()->local_endpoint().port();
+    ASSERT_THAT(p.leased(ep), Eq(1));
+    auto server = l.accept_client();
+
+    c.reset();
+    ASSERT_THAT(p.leased(ep), Eq(0));
+    ASSERT_THAT(p.idle(ep), Eq(1));
+
+    c = p.acquire(ep);
+    ASSERT_THAT(c->socket()->local_endpoint().port(), Eq(port));
+    ASSERT_FALSE(l.pending());
+}
+
+TEST(tcp_client_pool_test, dead_connections_are_not_reused)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+    tcp_client_pool p;
+
+    auto c = p.acquire(ep);
+    auto port = c->socket()->local_endpoint().port();
+    c.reset();
+    ASSERT_THAT(p.idle(ep), Eq(1));
+
+    l.accept_client()->close();
+    std::this_thread::sleep_for(20ms);
+    c = p.acquire(ep);
+    ASSERT_THAT(c->socket()->local_endpoint().port(), Ne(port));
+
+    auto server = l.accept_client();
+    std::vector<uint8_t> unread = {1};
+    server->socket()->send(unread);
+    ASSERT_TRUE(c->socket()->poll(1s, select_mode::read));
+
+    c.reset();
+    ASSERT_THAT(p.idle(ep), Eq(0));
+}
+
+TEST(tcp_client_pool_test, max_connections_waits_for_release)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+    tcp_client_pool_options options;
+    options.max_connections = 1;
+    tcp_client_pool p(options);
+
+    auto c = p.acquire(ep);
+    ASSERT_THROW(p.acquire(ep, 20ms), std::runtime_error);
+
+    auto waiter = std::async(std::launch::async, [&] { return p.acquire(ep); });
+    ASSERT_THAT(waiter.wait_for(20ms), Eq(std::future_status::timeout));
+
+    auto raw = c.get();
+    c.reset();
+    ASSERT_THAT(waiter.get().get(), Eq(raw));
+}
+
+TEST(tcp_client_pool_test, warm_and_evict_keep_min_idle)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+    tcp_client_pool_options options;
+    options.min_idle = 1;
+    options.idle_timeout = 10ms;
+    tcp_client_pool p(options);
+
+    ASSERT_THAT(p.warm(ep), Eq(1));
+    ASSERT_THAT(p.warm(ep), Eq(0));
+    ASSERT_THAT(p.idle(ep), Eq(1));
+
+    {
+        auto a = p.acquire(ep);
+        auto b = p.acquire(ep);
+    }
+
+    ASSERT_THAT(p.idle(ep), Eq(2));
+    std::this_thread::sleep_for(20ms);
+    ASSERT_THAT(p.evict(), Eq(1));
+    ASSERT_THAT(p.idle(ep), Eq(1));
+
+    p.clear();
+    ASSERT_THAT(p.idle(ep), Eq(0));
+    p.start(5ms);
+    ASSERT_TRUE(p.running());
+
+    for (int i = 0; i < 200 && p.idle(ep) == 0; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    p.stop();
+    ASSERT_THAT(p.idle(ep), Eq(1));
+}
+
+TEST(tcp_client_pool_test, connections_use_port_range_and_abortive_close)
+{
+    try
+    {
+        exa::socket probe(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+        probe.local_port_range(port_range{41000, 41009});
+    }
+    catch (const std::runtime_error& e)
+    {
+        GTEST_SKIP() << e.what();
+    }
+
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+    tcp_client_pool_options options;
+    options.local_port_range = port_range{41000, 41009};
+    options.abortive_close = true;
+    tcp_client_pool p(options);
+
+    auto c = p.acquire(ep);
+    ASSERT_THAT(c->socket()->local_endpoint().port(), AllOf(Ge(41000), Le(41009)));
+    ASSERT_TRUE(c->abortive_close());
+}
@@ -217,3 +217,35 @@ TEST(tcp_client_test, close_cancels_connect_async)
         ASSERT_FALSE(c.connected());
     }
 }
+
+TEST(tcp_client_test, abortive_close_resets_connection)
+{
+    auto l = tcp_listener::create(0);
+    l->start();
+
+    tcp_client c;
+    ASSERT_FALSE(c.abortive_close());
+    c.abortive_close(true);
+    ASSERT_TRUE(c.abortive_close());
+    c.connect(address::loopback, l->local_endpoint().port());
+
+    auto server = l->accept_client();
+    c.close();
+
+    std::vector<uint8_t> buffer(1);
+    ASSERT_TRUE(server->socket()->poll(1s, select_mode::read));
+    ASSERT_THROW(server->socket()->receive(buffer), std::system_error);
+}
+
+TEST(tcp_client_test, ctor_local_endpoint_defers_port_to_connect)
+{
+    auto l = tcp_listener::create(0);
+    l->start();
+
+    tcp_client c(address::loopback, 0);
+    ASSERT_TRUE(c.socket()->bind_address_no_port());
+    ASSERT_THAT(c.socket()->local_endpoint().port(), Eq(0));
+
+    c.connect(address::loopback, l->local_endpoint().port());
+    ASSERT_THAT(c.socket()->local_endpoint().port(), Ne(0));
+}
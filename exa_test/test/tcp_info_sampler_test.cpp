@@ -0,0 +1,103 @@
+#include <pch.h>
+#include <exa/tcp_info_sampler.hpp>
+#include <exa/tcp_listener.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(tcp_info_sampler_test, histogram_percentiles_follow_buckets)
+{
+    tcp_info_histogram h;
+    ASSERT_THAT(h.percentile(0.5), Eq(0));
+
+    for (uint64_t v : {0, 1, 3, 100, 1000})
+    {
+        h.add(v);
+    }
+
+    ASSERT_THAT(h.count(), Eq(5));
+    ASSERT_THAT(h.min(), Eq(0));
+    ASSERT_THAT(h.max(), Eq(1000));
+    ASSERT_THAT(h.mean(), DoubleEq(220.8));
+    ASSERT_THAT(h.buckets()[0], Eq(1));
+    ASSERT_THAT(h.buckets()[2], Eq(1));
+    ASSERT_THAT(h.percentile(0.6), Eq(3));
+    ASSERT_THAT(h.percentile(0.8), Eq(127));
+    ASSERT_THAT(h.percentile(1), Eq(1000));
+    ASSERT_THROW(h.percentile(1.5), std::out_of_range);
+
+    h.clear();
+    ASSERT_THAT(h.count(), Eq(0));
+}
+
+TEST(tcp_info_sampler_test, tcp_info_reports_established_connection)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+
+    std::vector<uint8_t> data(4096, 1);
+    client->stream()->write(data);
+    server->stream()->read(data);
+
+    auto info = client->tcp_info();
+    ASSERT_THAT(info.state, Eq(1));
+    ASSERT_THAT(info.send_mss, Gt(0));
+    ASSERT_THAT(info.congestion_window, Gt(0));
+    ASSERT_THAT(info.bytes_acked, Ge(4096));
+    ASSERT_THAT(server->tcp_info().bytes_received, Ge(4096));
+}
+
+TEST(tcp_info_sampler_test, sample_aggregates_live_connections)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+
+    tcp_info_sampler sampler;
+    sampler.add(client);
+    sampler.add(server->socket());
+    ASSERT_THROW(sampler.add(std::shared_ptr<exa::socket>()), std::invalid_argument);
+    ASSERT_THAT(sampler.size(), Eq(2));
+
+    ASSERT_THAT(sampler.sample(), Eq(2));
+    ASSERT_THAT(sampler.statistics().samples, Eq(2));
+    ASSERT_THAT(sampler.statistics().congestion_window.min(), Gt(0));
+
+    server.reset();
+    ASSERT_THAT(sampler.sample(), Eq(1));
+    ASSERT_THAT(sampler.size(), Eq(1));
+    ASSERT_THAT(sampler.statistics().rtt.count(), Eq(3));
+
+    sampler.clear();
+    ASSERT_THAT(sampler.statistics().samples, Eq(0));
+}
+
+TEST(tcp_info_sampler_test, start_samples_periodically)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto client = std::make_shared<tcp_client>();
+    client->connect(l.local_endpoint());
+    auto server = l.accept_client();
+
+    tcp_info_sampler sampler;
+    sampler.add(client);
+    ASSERT_THROW(sampler.start(0ms), std::out_of_range);
+    sampler.start(5ms);
+    ASSERT_TRUE(sampler.running());
+
+    for (int i = 0; i < 200 && sampler.statistics().samples < 3; ++i)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    sampler.stop();
+    ASSERT_FALSE(sampler.running());
+    ASSERT_THAT(sampler.statistics().samples, Ge(3));
+}
@@ -0,0 +1,142 @@
+#include <pch.h>
+#include <exa/tcp_listener_group.hpp>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(tcp_listener_group_test, ctor_zero_shards_throws)
+{
+    ASSERT_THROW(tcp_listener_group g(endpoint(address::loopback, 0), 0), std::out_of_range);
+}
+
+TEST(tcp_listener_group_test, start_binds_all_shards_to_same_port)
+{
+    tcp_listener_group g(endpoint(address::loopback, 0), 4);
+    ASSERT_FALSE(g.active());
+    ASSERT_THROW(g.listener(0), std::runtime_error);
+
+    g.start();
+    ASSERT_TRUE(g.active());
+    ASSERT_THAT(g.local_endpoint().port(), Ne(0));
+    ASSERT_THROW(g.cpu_steering(true), std::runtime_error);
+    ASSERT_THROW(g.listener(4), std::out_of_range);
+
+    for (size_t i = 0; i < g.size(); ++i)
+    {
+        ASSERT_THAT(g.listener(i)->local_endpoint().port(), Eq(g.local_endpoint().port()));
+        ASSERT_TRUE(g.listener(i)->reuse_port());
+    }
+
+    g.stop();
+    ASSERT_FALSE(g.active());
+}
+
+TEST(tcp_listener_group_test, handler_receives_all_clients)
+{
+    for (auto steering : {false, true})
+    {
+        tcp_listener_group g(endpoint(address::loopback, 0), 2);
+        g.cpu_steering(steering);
+
+        std::mutex m;
+        std::vector<std::shared_ptr<tcp_client>> accepted;
+        size_t max_shard = 0;
+        g.start([&](size_t shard, const std::shared_ptr<tcp_client>& c) {
+            std::lock_guard<std::mutex> _(m);
+            accepted.push_back(c);
+            max_shard = std::max(max_shard, shard);
+        });
+
+        std::vector<std::shared_ptr<tcp_client>> clients;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            clients.push_back(std::make_shared<tcp_client>());
+            clients.back()->connect(g.local_endpoint());
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            {
+                std::lock_guard<std::mutex> _(m);
+
+                if (accepted.size() == clients.size())
+                {
+                    break;
+                }
+            }
+
+            std::this_thread::sleep_for(5ms);
+        }
+
+        g.stop();
+        ASSERT_THAT(accepted.size(), Eq(clients.size()));
+        ASSERT_THAT(max_shard, Lt(2));
+        ASSERT_TRUE(accepted[0]->connected());
+    }
+}
+
+#ifndef _WIN32
+TEST(tcp_listener_group_test, steering_pins_shards_to_the_cpus_they_serve)
+{
+    constexpr size_t shards = 2;
+    tcp_listener_group g(endpoint(address::loopback, 0), shards);
+    g.cpu_steering(true);
+
+    std::mutex m;
+    std::vector<std::pair<size_t, cpu_set_t>> affinities;
+    std::vector<std::shared_ptr<tcp_client>> accepted;
+    g.start([&](size_t shard, const std::shared_ptr<tcp_client>& c) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        std::lock_guard<std::mutex> _(m);
+        affinities.emplace_back(shard, cpus);
+        accepted.push_back(c);
+    });
+
+    std::vector<std::shared_ptr<tcp_client>> clients;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        clients.push_back(std::make_shared<tcp_client>());
+        clients.back()->connect(g.local_endpoint());
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> _(m);
+
+            if (accepted.size() == clients.size())
+            {
+                break;
+            }
+        }
+
+        std::this_thread::sleep_for(5ms);
+    }
+
+    g.stop();
+    ASSERT_THAT(accepted.size(), Eq(clients.size()));
+
+    for (auto& [shard, cpus] : affinities)
+    {
+        if (shard >= std::thread::hardware_concurrency())
+        {
+            continue;
+        }
+
+        for (size_t c = 0; c < std::thread::hardware_concurrency(); ++c)
+        {
+            ASSERT_THAT(CPU_ISSET(c, &cpus) != 0, Eq(c % shards == shard));
+        }
+    }
+}
+#endif
@@ -1,6 +1,12 @@
 #include <pch.h>
 #include <exa/tcp_listener.hpp>
 #include <exa/tcp_client.hpp>
+#include <exa/unix_listener.hpp>
+#include <exa/unix_client.hpp>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 using namespace exa;
 using namespace testing;
@@ -113,3 +119,351 @@ TEST(tcp_listener_test, ipv6_only_works)
 
     exa::socket s(socket_type::stream, protocol_type::tcp);
 }
+
+TEST(tcp_listener_test, fast_open_connect_delivers_initial_data)
+{
+    tcp_listener l(address::loopback, 0);
+    l.fast_open(16);
+    l.start();
+    ASSERT_THAT(l.socket()->fast_open(), Eq(16));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        // The first connection only fetches the fast open cookie, the second one carries data in the SYN.
+        tcp_client c;
+        std::vector<uint8_t> data({'p', 'i', 'n', 'g'});
+        auto f = c.connect_async(endpoint(address::loopback, l.local_endpoint().port()), data);
+        auto s = l.accept_socket();
+
+        std::vector<uint8_t> received(4);
+        ASSERT_THAT(s->receive(received, socket_flags::wait_all), Eq(4));
+        ASSERT_THAT(f.get(), Eq(4));
+        ASSERT_THAT(received, ContainerEq(data));
+        ASSERT_THAT(c.connected(), Eq(true));
+    }
+}
+
+TEST(tcp_listener_test, accept_clients_drains_backlog)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+
+    std::vector<std::shared_ptr<tcp_client>> clients;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        clients.push_back(std::make_shared<tcp_client>());
+        clients.back()->connect(address::loopback, l.local_endpoint().port());
+    }
+
+    auto first = l.accept_clients_async(3).get();
+    ASSERT_THAT(first.size(), Eq(3));
+
+    auto rest = l.accept_clients();
+    ASSERT_THAT(rest.size(), Eq(2));
+    ASSERT_FALSE(l.pending());
+
+    for (auto& c : rest)
+    {
+        ASSERT_THAT(c->connected(), Eq(true));
+        ASSERT_THAT(c->socket()->protocol(), Eq(protocol_type::tcp));
+        ASSERT_THAT(c->socket()->blocking(), Eq(true));
+    }
+
+    ASSERT_THROW(l.accept_clients(0), std::out_of_range);
+}
+
+TEST(tcp_listener_test, accept_batch_nonblocking_sockets)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    l.socket()->blocking(false);
+
+    tcp_client a;
+    tcp_client b;
+    a.connect(address::loopback, l.local_endpoint().port());
+    b.connect(address::loopback, l.local_endpoint().port());
+
+    auto sockets = l.socket()->accept_batch(8, false);
+    ASSERT_THAT(sockets.size(), Eq(2));
+    ASSERT_THAT(sockets[0]->blocking(), Eq(false));
+    ASSERT_THAT(sockets[0]->type(), Eq(socket_type::stream));
+
+    std::vector<uint8_t> buffer(1);
+    ASSERT_THROW(sockets[0]->receive(buffer), std::system_error);
+}
+
+#ifndef _WIN32
+TEST(tcp_listener_test, accept_batch_keeps_accepted_sockets_on_error)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    l.socket()->blocking(false);
+
+    tcp_client a;
+    tcp_client b;
+    a.connect(address::loopback, l.local_endpoint().port());
+    b.connect(address::loopback, l.local_endpoint().port());
+
+    // Leaves room for exactly one more descriptor, so the second accept fails with EMFILE.
+    auto lowest = dup(0);
+    ::close(lowest);
+    rlimit original;
+    ASSERT_THAT(getrlimit(RLIMIT_NOFILE, &original), Eq(0));
+    rlimit limited = original;
+    limited.rlim_cur = static_cast<rlim_t>(lowest + 1);
+    ASSERT_THAT(setrlimit(RLIMIT_NOFILE, &limited), Eq(0));
+
+    std::vector<std::shared_ptr<exa::socket>> sockets;
+    auto first_threw = false;
+    auto second_threw = false;
+
+    try
+    {
+        sockets = l.socket()->accept_batch(8, false);
+    }
+    catch (const std::system_error&)
+    {
+        first_threw = true;
+    }
+    try
+    {
+        l.socket()->accept_batch(8, false);
+    }
+    catch (const std::system_error&)
+    {
+        second_threw = true;
+    }
+
+    // Restored before asserting, other tests need their descriptors.
+    ASSERT_THAT(setrlimit(RLIMIT_NOFILE, &original), Eq(0));
+    ASSERT_FALSE(first_threw);
+    ASSERT_THAT(sockets.size(), Eq(1));
+    ASSERT_TRUE(second_threw);
+    ASSERT_THAT(l.socket()->accept_batch(8, false).size(), Eq(1));
+}
+#endif
+
+TEST(tcp_listener_test, admission_live_limit_pauses_accepting)
+{
+    tcp_listener l(address::loopback, 0);
+    tcp_admission_options options;
+    options.max_live_connections = 1;
+    l.admission(options);
+    l.start();
+
+    tcp_client a;
+    tcp_client b;
+    a.connect(l.local_endpoint());
+    b.connect(l.local_endpoint());
+
+    auto first = l.accept_client();
+    ASSERT_THAT(l.counters().live, Eq(1));
+    ASSERT_THAT(l.accept_clients().size(), Eq(0));
+
+    auto second = l.accept_client_async();
+    ASSERT_THAT(second.wait_for(50ms), Eq(std::future_status::timeout));
+
+    first.reset();
+    auto client = second.get();
+    ASSERT_THAT(client->connected(), Eq(true));
+
+    auto counters = l.counters();
+    ASSERT_THAT(counters.live, Eq(1));
+    ASSERT_THAT(counters.accepted, Eq(2));
+    ASSERT_THAT(counters.rejected, Eq(0));
+    ASSERT_THAT(counters.deferred, Ge(2));
+}
+
+TEST(tcp_listener_test, admission_delay_until_next_token)
+{
+    tcp_listener l(address::loopback, 0);
+    tcp_admission_options options;
+    options.max_accept_rate = 10;
+    options.accept_burst = 1;
+    l.admission(options);
+    l.start();
+    ASSERT_THAT(l.admission_delay(), Eq(std::chrono::steady_clock::duration::zero()));
+
+    tcp_client a;
+    tcp_client b;
+    a.connect(l.local_endpoint());
+    b.connect(l.local_endpoint());
+    auto first = l.accept_client();
+
+    auto delay = l.admission_delay();
+    ASSERT_THAT(delay, Gt(50ms));
+    ASSERT_THAT(delay, Le(100ms));
+
+    options.max_accept_rate = 0;
+    options.max_live_connections = 1;
+    l.admission(options);
+    ASSERT_THAT(l.admission_delay(), Eq(std::chrono::steady_clock::duration::max()));
+
+    first.reset();
+    ASSERT_THAT(l.admission_delay(), Eq(std::chrono::steady_clock::duration::zero()));
+}
+
+TEST(tcp_listener_test, admission_rate_limit_rejects_excess)
+{
+    tcp_listener l(address::loopback, 0);
+    tcp_admission_options options;
+    options.max_accept_rate = 0.01;
+    options.accept_burst = 1;
+    options.shed_mode = tcp_shed_mode::reject;
+    l.admission(options);
+    l.start();
+
+    std::vector<std::shared_ptr<tcp_client>> clients;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        clients.push_back(std::make_shared<tcp_client>());
+        clients.back()->connect(l.local_endpoint());
+    }
+
+    std::vector<std::shared_ptr<tcp_client>> accepted;
+
+    for (int i = 0; i < 100 && l.counters().accepted + l.counters().rejected < 3; ++i)
+    {
+        for (auto& c : l.accept_clients())
+        {
+            accepted.push_back(c);
+        }
+    }
+
+    ASSERT_THAT(accepted.size(), Eq(1));
+    ASSERT_THAT(l.counters().rejected, Eq(2));
+
+    tcp_admission_options invalid;
+    invalid.max_accept_rate = -1;
+    ASSERT_THROW(l.admission(invalid), std::out_of_range);
+}
+
+TEST(tcp_listener_test, admission_latency_target_sheds_load)
+{
+    tcp_listener l(address::loopback, 0);
+    tcp_admission_options options;
+    options.latency_target = 1ms;
+    l.admission(options);
+    l.start();
+
+    tcp_client c;
+    c.connect(l.local_endpoint());
+
+    l.report_latency(10ms);
+    ASSERT_THAT(l.accept_clients().size(), Eq(0));
+    ASSERT_THAT(l.counters().deferred, Eq(1));
+
+    for (int i = 0; i < 20; ++i)
+    {
+        l.report_latency(0ms);
+    }
+
+    ASSERT_THAT(l.accept_clients().size(), Eq(1));
+}
+
+TEST(tcp_listener_test, defer_accept_applied_on_start)
+{
+    tcp_listener l(address::loopback, 0);
+    ASSERT_THROW(l.defer_accept(-1s), std::out_of_range);
+
+    l.defer_accept(5s);
+    ASSERT_THAT(l.defer_accept(), Eq(5s));
+    l.start();
+    ASSERT_THAT(l.socket()->defer_accept().count(), Gt(0));
+}
+
+TEST(tcp_listener_test, accept_client_with_data_reads_first_chunk)
+{
+    tcp_listener l(address::loopback, 0);
+    l.defer_accept(1s);
+    l.start();
+
+    buffer_pool pool(1024);
+    std::vector<uint8_t> request = {1, 2, 3, 4};
+
+    tcp_client c;
+    c.connect(l.local_endpoint());
+    c.socket()->send(request);
+
+    auto r = l.accept_client_with_data(pool);
+    ASSERT_THAT(r.client, NotNull());
+    ASSERT_THAT(r.size, Eq(request.size()));
+    ASSERT_THAT(r.buffer.size(), Eq(1024));
+    ASSERT_TRUE(std::equal(std::begin(request), std::end(request), std::begin(r.buffer)));
+
+    pool.release(std::move(r.buffer));
+    ASSERT_THAT(pool.available(), Eq(1));
+
+    tcp_client c2;
+    c2.connect(l.local_endpoint());
+    auto f = l.accept_client_with_data_async(pool);
+    c2.socket()->send(request);
+
+    auto r2 = f.get();
+    ASSERT_THAT(r2.size, Eq(request.size()));
+    ASSERT_THAT(pool.available(), Eq(0));
+}
+
+TEST(tcp_listener_test, accept_client_with_data_times_out_on_silent_client)
+{
+    tcp_listener l(address::loopback, 0);
+    l.start();
+
+    buffer_pool pool(1024);
+    tcp_client c;
+    c.connect(l.local_endpoint());
+
+    auto r = l.accept_client_with_data(pool, 50ms);
+    ASSERT_THAT(r.client, NotNull());
+    ASSERT_TRUE(r.timed_out);
+    ASSERT_THAT(r.size, Eq(0));
+    ASSERT_TRUE(r.client->connected());
+    pool.release(std::move(r.buffer));
+
+    tcp_client c2;
+    c2.connect(l.local_endpoint());
+    auto r2 = l.accept_client_with_data_async(pool, 50ms).get();
+    ASSERT_THAT(r2.client, NotNull());
+    ASSERT_TRUE(r2.timed_out);
+    ASSERT_THAT(r2.size, Eq(0));
+    ASSERT_THROW(l.accept_client_with_data(pool, -1ms), std::out_of_range);
+}
+
+TEST(tcp_listener_test, hand_off_keeps_queued_connections)
+{
+    unix_listener u(endpoint::unix_abstract("tcp_listener_test_hand_off"));
+    u.start();
+    unix_client predecessor;
+    predecessor.connect(u.local_endpoint());
+    auto successor = u.accept_client();
+
+    tcp_listener l(address::loopback, 0);
+    l.start();
+    auto ep = l.local_endpoint();
+
+    tcp_client queued;
+    queued.connect(ep);
+    auto unbound =
+        std::make_shared<exa::socket>(address_family::inter_network, socket_type::stream, protocol_type::tcp);
+    ASSERT_THROW(tcp_listener{unbound}, std::invalid_argument);
+
+    l.hand_off(predecessor);
+    ASSERT_FALSE(l.active());
+
+    auto adopted = tcp_listener::adopt(*successor);
+    ASSERT_TRUE(adopted->active());
+    ASSERT_THAT(adopted->local_endpoint().port(), Eq(ep.port()));
+
+    std::vector<uint8_t> data = {1, 2, 3};
+    std::vector<uint8_t> buffer(data.size());
+    queued.socket()->send(data);
+    auto server = adopted->accept_client();
+    ASSERT_THAT(server->socket()->receive(buffer), Eq(data.size()));
+    ASSERT_THAT(buffer, ContainerEq(data));
+
+    tcp_client later;
+    later.connect(ep);
+    ASSERT_THAT(adopted->accept_client(), NotNull());
+}
@@ -0,0 +1,294 @@
+#include <pch.h>
+#include <exa/tcp_server.hpp>
+#include <exa/unix_listener.hpp>
+#include <exa/unix_client.hpp>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    template <class Predicate>
+    bool wait_for(Predicate&& p)
+    {
+        for (int i = 0; i < 400 && !p(); ++i)
+        {
+            std::this_thread::sleep_for(5ms);
+        }
+
+        return p();
+    }
+}
+
+TEST(tcp_server_test, ctor_invalid_options_throws)
+{
+    tcp_server_options options;
+    options.io_loops = 0;
+    ASSERT_THROW(tcp_server s(endpoint(address::loopback, 0), tcp_server_handlers(), options), std::out_of_range);
+}
+
+TEST(tcp_server_test, echo_many_clients)
+{
+    tcp_server_handlers handlers;
+    handlers.received = [](auto&& c, auto data) { c->send(data); };
+
+    tcp_server_options options;
+    options.io_loops = 2;
+    tcp_server server(endpoint(address::loopback, 0), handlers, options);
+    server.start();
+    ASSERT_TRUE(server.active());
+
+    std::vector<std::shared_ptr<tcp_client>> clients;
+
+    for (int i = 0; i < 32; ++i)
+    {
+        clients.push_back(std::make_shared<tcp_client>());
+        clients.back()->connect(server.local_endpoint());
+    }
+
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        std::vector<uint8_t> data(1000, static_cast<uint8_t>(i));
+        std::vector<uint8_t> buffer(data.size());
+        clients[i]->stream()->write(data);
+
+        size_t n = 0;
+
+        while (n < buffer.size())
+        {
+            n += clients[i]->stream()->read(gsl::span<uint8_t>(buffer).subspan(static_cast<std::ptrdiff_t>(n)));
+        }
+
+        ASSERT_THAT(buffer, ContainerEq(data));
+    }
+
+    ASSERT_TRUE(wait_for([&] { return server.connections() == clients.size(); }));
+    server.stop();
+    ASSERT_FALSE(server.active());
+    ASSERT_THAT(server.connections(), Eq(0));
+}
+
+TEST(tcp_server_test, large_reply_is_queued_until_writable)
+{
+    std::vector<uint8_t> reply(8 * 1024 * 1024, 7);
+    std::atomic_size_t pending{0};
+
+    tcp_server_handlers handlers;
+    handlers.received = [&](auto&& c, auto) {
+        c->send(reply);
+        pending = c->pending_output();
+    };
+
+    tcp_server server(endpoint(address::loopback, 0), handlers);
+    server.start();
+
+    tcp_client client;
+    client.connect(server.local_endpoint());
+    client.stream()->write_byte(1);
+
+    std::vector<uint8_t> buffer(reply.size());
+    size_t n = 0;
+
+    while (n < buffer.size())
+    {
+        n += client.stream()->read(gsl::span<uint8_t>(buffer).subspan(static_cast<std::ptrdiff_t>(n)));
+    }
+
+    ASSERT_THAT(pending.load(), Gt(0));
+    ASSERT_THAT(buffer, ContainerEq(reply));
+}
+
+TEST(tcp_server_test, disconnect_and_close_call_handler)
+{
+    std::mutex m;
+    std::vector<std::error_code> disconnects;
+    std::shared_ptr<tcp_connection> first;
+
+    tcp_server_handlers handlers;
+    handlers.connected = [&](auto&& c) {
+        std::lock_guard<std::mutex> _(m);
+
+        if (!first)
+        {
+            first = c;
+        }
+    };
+    handlers.disconnected = [&](auto&&, auto&& ec) {
+        std::lock_guard<std::mutex> _(m);
+        disconnects.push_back(ec);
+    };
+
+    tcp_server server(endpoint(address::loopback, 0), handlers);
+    server.start();
+
+    auto a = std::make_shared<tcp_client>();
+    a->connect(server.local_endpoint());
+    ASSERT_TRUE(wait_for([&] {
+        std::lock_guard<std::mutex> _(m);
+        return first != nullptr;
+    }));
+
+    first->close();
+    ASSERT_TRUE(wait_for([&] {
+        std::lock_guard<std::mutex> _(m);
+        return disconnects.size() == 1;
+    }));
+    ASSERT_TRUE(first->closed());
+    ASSERT_THROW(first->send(std::vector<uint8_t>({1})), std::runtime_error);
+
+    auto b = std::make_shared<tcp_client>();
+    b->connect(server.local_endpoint());
+    ASSERT_TRUE(wait_for([&] { return server.connections() == 1; }));
+    b->close();
+    ASSERT_TRUE(wait_for([&] {
+        std::lock_guard<std::mutex> _(m);
+        return disconnects.size() == 2;
+    }));
+    ASSERT_FALSE(disconnects[1]);
+    ASSERT_THAT(server.connections(), Eq(0));
+}
+
+TEST(tcp_server_test, hand_off_drains_old_server)
+{
+    unix_listener u(endpoint::unix_abstract("tcp_server_test_hand_off"));
+    u.start();
+    unix_client predecessor;
+    predecessor.connect(u.local_endpoint());
+    auto successor = u.accept_client();
+
+    tcp_server_handlers old_handlers;
+    old_handlers.received = [](auto&& c, auto) { c->send(std::vector<uint8_t>{1}); };
+    tcp_server_handlers new_handlers;
+    new_handlers.received = [](auto&& c, auto) { c->send(std::vector<uint8_t>{2}); };
+
+    tcp_server_options options;
+    options.io_loops = 1;
+    tcp_server old_server(endpoint(address::loopback, 0), old_handlers, options);
+    old_server.start();
+
+    auto roundtrip = [](tcp_client& c) {
+        std::vector<uint8_t> buffer(1);
+        c.stream()->write(std::vector<uint8_t>{0});
+        c.stream()->read(buffer);
+        return buffer[0];
+    };
+
+    tcp_client existing;
+    existing.connect(old_server.local_endpoint());
+    ASSERT_THAT(roundtrip(existing), Eq(1));
+
+    auto ep = old_server.local_endpoint();
+    old_server.hand_off(predecessor);
+    ASSERT_THROW(old_server.hand_off(predecessor), std::runtime_error);
+    ASSERT_TRUE(old_server.active());
+
+    tcp_server new_server(tcp_listener::adopt(*successor), new_handlers, options);
+    new_server.start();
+
+    tcp_client fresh;
+    fresh.connect(ep);
+    ASSERT_THAT(roundtrip(fresh), Eq(2));
+    ASSERT_THAT(roundtrip(existing), Eq(1));
+
+    old_server.stop();
+    ASSERT_THAT(roundtrip(fresh), Eq(2));
+}
+
+TEST(tcp_server_test, hand_off_to_plain_listener_accepts)
+{
+    unix_listener u(endpoint::unix_abstract("tcp_server_test_hand_off_plain"));
+    u.start();
+    unix_client predecessor;
+    predecessor.connect(u.local_endpoint());
+    auto successor = u.accept_client();
+
+    tcp_server_options options;
+    options.io_loops = 1;
+    tcp_server server(endpoint(address::loopback, 0), tcp_server_handlers(), options);
+    server.start();
+    auto ep = server.local_endpoint();
+    server.hand_off(predecessor);
+
+    auto adopted = tcp_listener::adopt(*successor);
+    ASSERT_TRUE(adopted->socket()->blocking());
+
+    tcp_client c;
+    c.connect(ep);
+    ASSERT_THAT(adopted->accept_client(), NotNull());
+}
+
+TEST(tcp_server_test, paused_admission_waits_for_next_token)
+{
+    std::atomic_int connected{0};
+    tcp_server_handlers handlers;
+    handlers.connected = [&](auto&&) { connected += 1; };
+
+    tcp_server_options options;
+    options.io_loops = 1;
+    tcp_server server(endpoint(address::loopback, 0), handlers, options);
+    tcp_admission_options admission;
+    admission.max_accept_rate = 5;
+    admission.accept_burst = 1;
+    server.listener()->admission(admission);
+    server.start();
+
+    std::vector<std::shared_ptr<tcp_client>> clients;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        clients.push_back(std::make_shared<tcp_client>());
+        clients.back()->connect(server.local_endpoint());
+    }
+
+    ASSERT_TRUE(wait_for([&] { return connected == 3; }));
+    // Woken for each token instead of polling the paused listener.
+    ASSERT_THAT(server.listener()->counters().deferred, Le(10));
+}
+
+#ifndef _WIN32
+TEST(tcp_server_test, accept_backs_off_while_out_of_descriptors)
+{
+    std::atomic_int connected{0};
+    std::atomic_int failed{0};
+    tcp_server_handlers handlers;
+    handlers.connected = [&](auto&&) { connected += 1; };
+    handlers.accept_failed = [&](auto&&) { failed += 1; };
+
+    tcp_server_options options;
+    options.io_loops = 1;
+    tcp_server server(endpoint(address::loopback, 0), handlers, options);
+    server.start();
+
+    tcp_client c;
+    auto lowest = dup(0);
+    ::close(lowest);
+    rlimit original;
+    ASSERT_THAT(getrlimit(RLIMIT_NOFILE, &original), Eq(0));
+    rlimit limited = original;
+    limited.rlim_cur = static_cast<rlim_t>(lowest);
+    ASSERT_THAT(setrlimit(RLIMIT_NOFILE, &limited), Eq(0));
+
+    // Every accept fails with EMFILE while the connection waits in the backlog.
+    c.connect(server.local_endpoint());
+    rusage before;
+    rusage after;
+    getrusage(RUSAGE_SELF, &before);
+    std::this_thread::sleep_for(300ms);
+    getrusage(RUSAGE_SELF, &after);
+
+    // Restored before asserting, other tests need their descriptors.
+    ASSERT_THAT(setrlimit(RLIMIT_NOFILE, &original), Eq(0));
+    auto cpu = [](const rusage& u) {
+        return std::chrono::seconds(u.ru_utime.tv_sec + u.ru_stime.tv_sec) +
+               std::chrono::microseconds(u.ru_utime.tv_usec + u.ru_stime.tv_usec);
+    };
+    ASSERT_THAT(cpu(after) - cpu(before), Lt(100ms));
+    ASSERT_TRUE(wait_for([&] { return connected == 1; }));
+    ASSERT_THAT(failed.load(), Eq(0));
+}
+#endif
@@ -301,3 +301,239 @@ TEST(udp_client_test, send_async_receive_async_connected_success)
     ASSERT_THAT(result.endpoint.port(), Eq(sender.socket()->local_endpoint().port()));
     ASSERT_THAT(result.buffer.size(), Ne(0));
 }
+
+TEST(udp_client_test, send_batch_receive_batch_success)
+{
+    for (auto ipv4 : {false, true})
+    {
+        auto address = ipv4 ? address::loopback : address::ipv6_loopback;
+        udp_client receiver(endpoint(address, 0));
+        udp_client sender(endpoint(address, 0));
+        endpoint target(address, receiver.socket()->local_endpoint().port());
+
+        std::vector<uint8_t> first({1});
+        std::vector<uint8_t> second({2, 2});
+        std::vector<uint8_t> third({3, 3, 3});
+        std::array<socket_send_message, 3> outgoing = {
+            {{first, target}, {second, target}, {third, target}}};
+        ASSERT_THAT(sender.send_batch(outgoing), Eq(3));
+
+        std::vector<std::vector<uint8_t>> buffers(4, std::vector<uint8_t>(16));
+        std::array<socket_receive_message, 4> incoming;
+
+        for (size_t i = 0; i < incoming.size(); ++i)
+        {
+            incoming[i].buffer = buffers[i];
+        }
+
+        size_t n = 0;
+
+        while (n < 3)
+        {
+            n += receiver.receive_batch(gsl::span<socket_receive_message>(incoming).subspan(n));
+        }
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            ASSERT_THAT(incoming[i].bytes, Eq(i + 1));
+            ASSERT_THAT(incoming[i].buffer[0], Eq(i + 1));
+            ASSERT_THAT(incoming[i].endpoint.port(), Eq(sender.socket()->local_endpoint().port()));
+        }
+    }
+}
+
+TEST(udp_client_test, send_batch_async_receive_batch_async_connected_success)
+{
+    udp_client receiver("localhost", 0);
+    udp_client sender("localhost", receiver.socket()->local_endpoint().port());
+
+    std::vector<uint8_t> data({7, 8});
+    std::array<socket_send_message, 1> outgoing = {{{data, endpoint()}}};
+    ASSERT_THAT(sender.send_batch_async(outgoing).get(), Eq(1));
+
+    std::vector<uint8_t> buffer(16);
+    std::array<socket_receive_message, 2> incoming;
+    incoming[0].buffer = buffer;
+    incoming[1].buffer = buffer;
+
+    ASSERT_THAT(receiver.receive_batch_async(incoming).get(), Eq(1));
+    ASSERT_THAT(incoming[0].bytes, Eq(2));
+    ASSERT_THAT(buffer[1], Eq(8));
+}
+
+TEST(udp_client_test, batch_empty_throws)
+{
+    udp_client c;
+
+    ASSERT_THROW(c.receive_batch(gsl::span<socket_receive_message>()), std::invalid_argument);
+    ASSERT_THROW(c.send_batch(gsl::span<const socket_send_message>()), std::invalid_argument);
+}
+
+TEST(udp_client_test, segments_split_buffer)
+{
+    std::vector<uint8_t> data(2500);
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i / 1000);
+    }
+
+    udp_segments segments(data, 1000);
+    ASSERT_THAT(segments.size(), Eq(3));
+    ASSERT_THAT(segments.bytes(), Eq(2500));
+    ASSERT_THAT(segments[2].size(), Eq(500));
+    ASSERT_THROW(segments[3], std::out_of_range);
+
+    uint8_t index = 0;
+
+    for (auto segment : segments)
+    {
+        ASSERT_THAT(segment[0], Eq(index));
+        ASSERT_THAT(segment[segment.size() - 1], Eq(index));
+        ++index;
+    }
+
+    ASSERT_THAT(udp_segments().size(), Eq(0));
+    ASSERT_THROW(udp_segments(data, 0), std::invalid_argument);
+}
+
+TEST(udp_client_test, send_segments_receive_segments_success)
+{
+    udp_client receiver(endpoint(address::loopback, 0));
+    udp_client sender(endpoint(address::loopback, 0));
+    receiver.receive_offload(true);
+    ASSERT_THAT(receiver.receive_offload(), Eq(true));
+
+    std::vector<uint8_t> data(4000);
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i / 1000);
+    }
+
+    ASSERT_THAT(sender.send_segments(data, 1000, endpoint(address::loopback, receiver.socket()->local_endpoint().port())),
+                Eq(4000));
+
+    // The kernel may coalesce any number of the datagrams, so collect segments until all have arrived.
+    std::vector<uint8_t> buffer(0x10000);
+    size_t bytes = 0;
+
+    while (bytes < data.size())
+    {
+        endpoint ep;
+        auto segments = receiver.receive_segments(buffer, ep);
+        ASSERT_THAT(ep.port(), Eq(sender.socket()->local_endpoint().port()));
+        ASSERT_THAT(segments.segment_size(), Eq(1000));
+
+        for (auto segment : segments)
+        {
+            ASSERT_THAT(segment.size(), Eq(1000));
+            ASSERT_THAT(segment[0], Eq(bytes / 1000));
+            bytes += static_cast<size_t>(segment.size());
+        }
+    }
+
+    ASSERT_THAT(bytes, Eq(4000));
+}
+
+TEST(udp_client_test, send_segments_invalid_size_throws)
+{
+    udp_client c(endpoint(address::loopback, 0));
+    std::vector<uint8_t> data(10);
+
+    ASSERT_THROW(c.send_segments(data, 0, c.socket()->local_endpoint()), std::out_of_range);
+    ASSERT_THROW(c.send_segments(data, 0x10000, c.socket()->local_endpoint()), std::out_of_range);
+}
+
+TEST(udp_client_test, timestamped_send_receive_success)
+{
+    udp_client receiver(endpoint(address::loopback, 0));
+    udp_client sender(endpoint(address::loopback, 0));
+    receiver.timestamping(true);
+    sender.timestamping(true);
+    ASSERT_THAT(receiver.timestamping(), Eq(true));
+    sender.connect(receiver.socket()->local_endpoint());
+
+    // Receive stamps may be missing for a while after enabling, so this retries until a packet got stamped.
+    for (int i = 0; i < 100; ++i)
+    {
+        auto before = std::chrono::system_clock::now().time_since_epoch();
+        socket_timestamp sent;
+        ASSERT_THAT(sender.socket()->send(std::vector<uint8_t>({1, 2, 3}), sent), Eq(3));
+
+        endpoint ep;
+        socket_timestamp received;
+        auto data = receiver.receive(ep, received);
+        auto after = std::chrono::system_clock::now().time_since_epoch();
+
+        ASSERT_THAT(data, ElementsAre(1, 2, 3));
+        ASSERT_THAT(ep.port(), Eq(sender.socket()->local_endpoint().port()));
+        ASSERT_TRUE(sent.software.has_value());
+        ASSERT_THAT(*sent.software, Ge(before));
+
+        if (received.software)
+        {
+            ASSERT_THAT(*sent.software, Le(*received.software));
+            ASSERT_THAT(*received.software, Le(after));
+            return;
+        }
+
+        std::this_thread::sleep_for(1ms);
+    }
+
+    FAIL() << "No received packet got a timestamp.";
+}
+
+TEST(udp_client_test, timestamped_send_not_enabled_throws)
+{
+    udp_client c(endpoint(address::loopback, 0));
+    c.connect(c.socket()->local_endpoint());
+    socket_timestamp timestamp;
+
+    ASSERT_THROW(c.socket()->send(std::vector<uint8_t>({1}), timestamp), std::runtime_error);
+}
+
+TEST(udp_client_test, receive_into_buffer_reports_truncation)
+{
+    udp_client receiver(endpoint(address::loopback, 0));
+    udp_client sender(endpoint(address::loopback, 0));
+    auto ep = receiver.socket()->local_endpoint();
+    ASSERT_THAT(sender.send(std::vector<uint8_t>({1, 2}), ep), Eq(2));
+    ASSERT_THAT(sender.send(std::vector<uint8_t>({1, 2, 3, 4, 5, 6}), ep), Eq(6));
+
+    std::array<uint8_t, 4> buffer;
+    endpoint from;
+    auto d = receiver.receive(buffer, from);
+    ASSERT_THAT(std::vector<uint8_t>(std::begin(d.data), std::end(d.data)), ElementsAre(1, 2));
+    ASSERT_FALSE(d.truncated());
+    ASSERT_THAT(from.port(), Eq(sender.socket()->local_endpoint().port()));
+
+    auto r = receiver.receive_async(buffer).get();
+    ASSERT_THAT(r.datagram.data.data(), Eq(buffer.data()));
+    ASSERT_THAT(r.datagram.data.size(), Eq(4));
+    ASSERT_THAT(r.datagram.size, Eq(6));
+    ASSERT_TRUE(r.datagram.truncated());
+    ASSERT_THAT(r.endpoint.port(), Eq(sender.socket()->local_endpoint().port()));
+}
+
+TEST(udp_client_test, receive_async_pool_reuses_buffers)
+{
+    udp_client receiver(endpoint(address::loopback, 0));
+    udp_client sender(endpoint(address::loopback, 0));
+    auto ep = receiver.socket()->local_endpoint();
+    buffer_pool pool(16);
+
+    ASSERT_THAT(sender.send(std::vector<uint8_t>({1, 2, 3}), ep), Eq(3));
+    auto r = receiver.receive_async(pool).get();
+    ASSERT_THAT(r.buffer, ElementsAre(1, 2, 3));
+    ASSERT_THAT(r.size, Eq(3));
+    auto data = r.buffer.data();
+    pool.release(std::move(r.buffer));
+    ASSERT_THAT(pool.available(), Eq(1));
+
+    ASSERT_THAT(sender.send(std::vector<uint8_t>(20, 7), ep), Eq(20));
+    r = receiver.receive_async(pool).get();
+    ASSERT_THAT(r.buffer.data(), Eq(data));
+    ASSERT_THAT(r.buffer.size(), Eq(16));
+    ASSERT_THAT(r.size, Eq(20));
+}
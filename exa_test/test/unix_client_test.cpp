@@ -0,0 +1,147 @@
+#include <pch.h>
+#include <exa/unix_listener.hpp>
+#include <exa/unix_client.hpp>
+
+using namespace exa;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+    auto socket_path = "unix_client_test.sock";
+}
+
+TEST(unix_client_test, endpoint_path_and_abstract_roundtrip)
+{
+    auto path = endpoint::unix_path(socket_path);
+    ASSERT_THAT(path.family(), Eq(address_family::unix_descriptor));
+    ASSERT_THAT(path.path(), Eq(socket_path));
+    ASSERT_FALSE(path.abstract());
+
+    auto abstract = endpoint::unix_abstract("exa_test");
+    ASSERT_THAT(abstract.family(), Eq(address_family::unix_descriptor));
+    ASSERT_THAT(abstract.path(), Eq("exa_test"));
+    ASSERT_TRUE(abstract.abstract());
+
+    for (auto& ep : {path, abstract})
+    {
+        auto data = ep.serialize();
+        sockaddr_storage storage = {0};
+        memcpy(&storage, data.data(), data.size());
+
+        endpoint e(storage, data.size());
+        ASSERT_THAT(e.family(), Eq(address_family::unix_descriptor));
+        ASSERT_THAT(e.path(), Eq(ep.path()));
+        ASSERT_THAT(e.abstract(), Eq(ep.abstract()));
+    }
+
+    ASSERT_THROW(endpoint::unix_path(""), std::invalid_argument);
+    ASSERT_THROW(endpoint::unix_path(std::string(200, 'a')).serialize(), std::invalid_argument);
+}
+
+TEST(unix_client_test, path_listener_stream_roundtrip)
+{
+    std::remove(socket_path);
+    unix_listener l(socket_path);
+    l.start();
+    ASSERT_THAT(l.local_endpoint().path(), Eq(socket_path));
+
+    unix_client c;
+    c.connect(socket_path);
+    auto server = l.accept_client();
+    ASSERT_TRUE(c.connected());
+
+    std::vector<uint8_t> data = {1, 2, 3, 4, 5};
+    std::vector<uint8_t> buffer(data.size());
+    c.stream()->write(data);
+    ASSERT_THAT(server->stream()->read(buffer), Eq(5));
+    ASSERT_THAT(buffer, ContainerEq(data));
+
+    l.stop();
+    ASSERT_FALSE(std::ifstream(socket_path).good());
+}
+
+TEST(unix_client_test, abstract_listener_accept_async)
+{
+    auto ep = endpoint::unix_abstract("exa_test_abstract");
+    unix_listener l(ep);
+    l.start();
+    ASSERT_TRUE(l.local_endpoint().abstract());
+    ASSERT_THAT(l.local_endpoint().path(), Eq("exa_test_abstract"));
+
+    auto accepted = l.accept_client_async();
+    unix_client c;
+    c.connect(ep);
+    auto server = accepted.get();
+
+    std::vector<uint8_t> data = {42};
+    std::vector<uint8_t> buffer(1);
+    server->stream()->write(data);
+    ASSERT_THAT(c.stream()->read(buffer), Eq(1));
+    ASSERT_THAT(buffer[0], Eq(42));
+}
+
+TEST(unix_client_test, send_descriptors_passes_pipe)
+{
+    auto ep = endpoint::unix_abstract("exa_test_descriptors");
+    unix_listener l(ep);
+    l.start();
+    unix_client c;
+    c.connect(ep);
+    auto server = l.accept_client();
+
+#ifdef _WIN32
+    std::vector<socket::native_handle_type> descriptors = {c.socket()->native_handle()};
+    ASSERT_THROW(c.send_descriptors(descriptors, std::vector<uint8_t>({1})), std::runtime_error);
+#else
+    int fds[2];
+    ASSERT_THAT(pipe(fds), Eq(0));
+
+    std::vector<socket::native_handle_type> descriptors = {fds[1]};
+    ASSERT_THROW(c.send_descriptors(descriptors, std::vector<uint8_t>()), std::invalid_argument);
+    ASSERT_THAT(c.send_descriptors(descriptors, std::vector<uint8_t>({7})), Eq(1));
+    ::close(fds[1]);
+
+    std::vector<uint8_t> buffer(1);
+    std::vector<socket::native_handle_type> received;
+    ASSERT_THAT(server->receive_descriptors(buffer, received), Eq(1));
+    ASSERT_THAT(buffer[0], Eq(7));
+    ASSERT_THAT(received.size(), Eq(1));
+
+    uint8_t value = 9;
+    ASSERT_THAT(::write(received[0], &value, 1), Eq(1));
+    ::close(received[0]);
+    value = 0;
+    ASSERT_THAT(::read(fds[0], &value, 1), Eq(1));
+    ASSERT_THAT(value, Eq(9));
+    ::close(fds[0]);
+#endif
+}
+
+#ifndef _WIN32
+TEST(unix_client_test, receive_truncated_descriptors_throws)
+{
+    auto ep = endpoint::unix_abstract("exa_test_truncated_descriptors");
+    unix_listener l(ep);
+    l.start();
+    unix_client c;
+    c.connect(ep);
+    auto server = l.accept_client();
+
+    // Credentials take up part of the control buffer, so the largest descriptor set no longer fits.
+    int enable = 1;
+    ASSERT_THAT(setsockopt(server->socket()->native_handle(), SOL_SOCKET, SO_PASSCRED, &enable, sizeof(enable)),
+                Eq(0));
+    int fds[2];
+    ASSERT_THAT(pipe(fds), Eq(0));
+    std::vector<socket::native_handle_type> descriptors(253, fds[1]);
+    ASSERT_THAT(c.send_descriptors(descriptors, std::vector<uint8_t>({7})), Eq(1));
+
+    std::vector<uint8_t> buffer(1);
+    std::vector<socket::native_handle_type> received;
+    ASSERT_THROW(server->receive_descriptors(buffer, received), std::runtime_error);
+    ASSERT_TRUE(received.empty());
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+#endif